@@ -9,15 +9,37 @@ int main(int argc, char *argv[])
         return 0;
     }
 
-    const char *dir_path = argv[1];
+    if (!parse_args(argc, argv, &runner_options))
+    {
+        show_help(argv[0]);
+        return 1;
+    }
+
+    const char *dir_path = runner_options.dir_path;
+
+    install_interrupt_handlers();
+
+    if (!configure_compiler())
+        return 1;
+
+    if (runner_options.isolate && !configure_isolation())
+        return 1;
 
     ensure_build_dir();
 
+    if (runner_options.trace_path)
+    {
+        trace_start(&runner_trace);
+        trace_name_track(&runner_trace, TRACE_RUNNER_TRACK, "runner");
+    }
+
     int total = 0;
     int passed = 0;
 
     printf("🔎 Searching tests in %s\n\n", dir_path);
 
+    long long suite_start = trace_now_ns();
+
 #ifdef _WIN32
 
     char search_path[512];
@@ -67,9 +89,24 @@ int main(int argc, char *argv[])
 
 #endif
 
+    trace_span(&runner_trace, "runner", "suite", dir_path, TRACE_RUNNER_TRACK,
+               suite_start, trace_now_ns());
+
     printf("====================================\n");
-    printf("Tests: %d | Passed: %d | Failed: %d\n",
+    printf("Tests: %d | Passed: %d | Failed: %d",
            total, passed, total - passed);
 
+    if (runner_timeouts > 0)
+        printf(" | Timed out: %d", runner_timeouts);
+
+    printf("\n");
+
+    int regressions = finish_timings();
+
+    finish_trace();
+
+    if (regressions > 0 && runner_options.fail_on_regression)
+        return 1;
+
     return (passed == total) ? 0 : 1;
 }
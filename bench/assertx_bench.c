@@ -0,0 +1,574 @@
+/*
+ * assertx self-benchmark
+ *
+ * Generates a synthetic test tree and pushes it through run_test_file()
+ * in every execution mode, timing each pipeline phase from the spans
+ * the runner records for --trace. One JSON line per scenario is
+ * appended to the results file so runs can be compared across commits.
+ *
+ *   make bench
+ *   make bench BENCH_ARGS="--files=50 --functions=40 --depth=8"
+ */
+
+#include "../src/assertx_runner.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+
+#define BENCH_TREE BUILD_DIR "/bench_tree"
+#define BENCH_RESULTS BUILD_DIR "/assertx_bench.jsonl"
+#define BENCH_BASELINE BUILD_DIR "/bench_baseline.txt"
+
+/* list_tree() reads at most this many generated files */
+#define BENCH_MAX_FILES 4096
+
+
+/* =========================
+   OPTIONS
+========================= */
+
+typedef struct {
+    int files;
+    int functions;
+    int depth;
+    const char *output;
+} BenchOptions;
+
+static BenchOptions bench_options = {
+    .files = 20,
+    .functions = 20,
+    .depth = 4,
+    .output = BENCH_RESULTS,
+};
+
+int bench_parse_args(int argc, char *argv[], BenchOptions *options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+
+        if (strncmp(arg, "--files=", 8) == 0)
+            options->files = atoi(arg + 8);
+        else if (strncmp(arg, "--functions=", 12) == 0)
+            options->functions = atoi(arg + 12);
+        else if (strncmp(arg, "--depth=", 8) == 0)
+            options->depth = atoi(arg + 8);
+        else if (strncmp(arg, "--output=", 9) == 0)
+            options->output = arg + 9;
+        else if (strcmp(arg, "--isolate") == 0 || strncmp(arg, "--isolate=", 10) == 0)
+        {
+            runner_options.isolate = isolate_supported();
+            runner_options.isolate_cpus = arg[9] ? arg + 10 : NULL;
+        }
+        else
+        {
+            printf("❌ Unknown option: %s\n", arg);
+            printf("Usage: %s [--files=n] [--functions=n] [--depth=n] [--output=file] [--isolate[=cpus]]\n", argv[0]);
+            return 0;
+        }
+    }
+
+    if (options->files < 1 || options->functions < 1 || options->depth < 1)
+    {
+        printf("❌ --files, --functions and --depth must be at least 1\n");
+        return 0;
+    }
+
+    if (options->files > BENCH_MAX_FILES)
+    {
+        printf("❌ --files can be at most %d\n", BENCH_MAX_FILES);
+        return 0;
+    }
+
+    return 1;
+}
+
+
+/* =========================
+   TREE GENERATOR
+========================= */
+
+int copy_file(const char *from, const char *to)
+{
+    FILE *in;
+    FILE *out;
+
+    if (fopen_safe(in, from, "rb"))
+        return 0;
+
+    if (fopen_safe(out, to, "wb"))
+    {
+        fclose(in);
+        return 0;
+    }
+
+    char buffer[8192];
+    size_t n;
+
+    while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+        fwrite(buffer, 1, n, out);
+
+    fclose(in);
+    fclose(out);
+
+    return 1;
+}
+
+/* the deepest header is rewritten to invalidate every cached binary */
+void write_leaf_header(int depth, int generation)
+{
+    char path[512];
+
+    snprintf(path, sizeof(path), "%s/inc/level_%d.h", BENCH_TREE, depth - 1);
+
+    FILE *f = fopen(path, "w");
+
+    if (!f)
+        return;
+
+    fprintf(f, "/* generation %d */\n", generation);
+    fprintf(f, "static inline int bench_level_%d(int x) { return x + 1; }\n", depth - 1);
+    fclose(f);
+}
+
+/*
+ * <tree>/gen_NNN_test.c, each with `functions` test_ functions, one
+ * bench_ function and one fuzz_ target, all including a chain of `depth` headers in
+ * <tree>/inc so the dependency scan has something to walk.
+ */
+int generate_tree(const BenchOptions *options)
+{
+    char path[512];
+
+    ensure_dir(BENCH_TREE "/inc");
+
+    if (!copy_file("tests/xassert.h", BENCH_TREE "/xassert.h"))
+    {
+        printf("❌ Run from the repository root, tests/xassert.h was not found\n");
+        return 0;
+    }
+
+    for (int level = 0; level < options->depth - 1; level++)
+    {
+        snprintf(path, sizeof(path), "%s/inc/level_%d.h", BENCH_TREE, level);
+
+        FILE *f = fopen(path, "w");
+
+        if (!f)
+            return 0;
+
+        fprintf(f, "#include \"level_%d.h\"\n", level + 1);
+        fprintf(f, "static inline int bench_level_%d(int x) { return bench_level_%d(x) + 1; }\n",
+                level, level + 1);
+        fclose(f);
+    }
+
+    write_leaf_header(options->depth, 0);
+
+    for (int file = 0; file < options->files; file++)
+    {
+        snprintf(path, sizeof(path), "%s/gen_%03d_test.c", BENCH_TREE, file);
+
+        FILE *f = fopen(path, "w");
+
+        if (!f)
+            return 0;
+
+        fprintf(f, "#include \"xassert.h\"\n");
+        fprintf(f, "#include \"inc/level_0.h\"\n\n");
+
+        for (int fn = 0; fn < options->functions; fn++)
+        {
+            fprintf(f, "void test_gen_%d()\n{\n", fn);
+            fprintf(f, "    assert_equal(bench_level_0(%d), %d, \"level chain should add the depth\");\n",
+                    fn, fn + options->depth);
+            fprintf(f, "}\n\n");
+        }
+
+        fprintf(f, "void bench_gen()\n{\n");
+        fprintf(f, "    volatile int sink = 0;\n");
+        fprintf(f, "    for (int i = 0; i < 1000; i++)\n");
+        fprintf(f, "        sink += bench_level_0(i);\n");
+        fprintf(f, "}\n\n");
+
+        fprintf(f, "void fuzz_gen(const uint8_t *data, size_t len)\n{\n");
+        fprintf(f, "    volatile int sink = 0;\n");
+        fprintf(f, "    for (size_t i = 0; i < len; i++)\n");
+        fprintf(f, "        sink += bench_level_0(data[i]);\n");
+        fprintf(f, "}\n");
+
+        fclose(f);
+    }
+
+    /* files left over from a larger --files would otherwise be run too */
+    for (int file = options->files; file < BENCH_MAX_FILES; file++)
+    {
+        snprintf(path, sizeof(path), "%s/gen_%03d_test.c", BENCH_TREE, file);
+
+        if (remove(path) != 0)
+            break;
+    }
+
+    return 1;
+}
+
+
+/* =========================
+   MEASUREMENT
+========================= */
+
+typedef struct {
+    const char *name;
+    long long wall_ns;
+    long long codegen_ns;
+    long long compile_ns;
+    long long cache_ns;
+    long long run_ns;
+    long long collect_ns;
+    int compiled;
+    int files;
+    int passed;
+} BenchResult;
+
+static int saved_stdout = -1;
+
+/* the runner and the test binaries write a lot, keep the report readable */
+void silence_stdout(int silent)
+{
+    fflush(stdout);
+
+#ifndef _WIN32
+    if (silent)
+    {
+        int null_fd = open("/dev/null", O_WRONLY);
+
+        saved_stdout = dup(STDOUT_FILENO);
+
+        if (null_fd >= 0)
+        {
+            dup2(null_fd, STDOUT_FILENO);
+            close(null_fd);
+        }
+    }
+    else if (saved_stdout >= 0)
+    {
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+        saved_stdout = -1;
+    }
+#else
+    (void)silent;
+#endif
+}
+
+int list_tree(char names[][64], int max)
+{
+    int count = 0;
+
+#ifndef _WIN32
+    DIR *dir = opendir(BENCH_TREE);
+
+    if (!dir)
+        return 0;
+
+    struct dirent *entry;
+
+    while ((entry = readdir(dir)) != NULL && count < max)
+    {
+        if (ends_with(entry->d_name, "_test.c"))
+            snprintf(names[count++], 64, "%s", entry->d_name);
+    }
+
+    closedir(dir);
+#else
+    (void)names;
+    (void)max;
+#endif
+
+    return count;
+}
+
+BenchResult bench_discover(int repeats)
+{
+    static char names[BENCH_MAX_FILES][64];
+    BenchResult result = {"discover", 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+    long long start = trace_now_ns();
+
+    for (int i = 0; i < repeats; i++)
+        result.files = list_tree(names, BENCH_MAX_FILES);
+
+    result.wall_ns = (trace_now_ns() - start) / repeats;
+
+    return result;
+}
+
+BenchResult bench_extract(char names[][64], int count)
+{
+    BenchResult result = {"extract", 0, 0, 0, 0, 0, 0, 0, count, 0};
+    char functions[MAX_FUNCTIONS][256];
+    int timeouts[MAX_FUNCTIONS];
+    int fixtures[FIXTURE_COUNT];
+    FILE *sink = tmpfile();
+
+    if (!sink)
+        return result;
+
+    long long start = trace_now_ns();
+
+    for (int i = 0; i < count; i++)
+    {
+        char path[512];
+
+        snprintf(path, sizeof(path), "%s/%s", BENCH_TREE, names[i]);
+
+        int n = extract_test_functions(path, sink, functions);
+
+        extract_timeouts(path, functions, n, timeouts);
+        extract_fixtures(path, sink, fixtures);
+        source_uses_xtest(path);
+    }
+
+    result.wall_ns = trace_now_ns() - start;
+
+    fclose(sink);
+
+    return result;
+}
+
+/* runs the whole tree through run_test_file() and adds up the runner spans */
+BenchResult bench_pipeline(const char *name, char names[][64], int count)
+{
+    BenchResult result = {name, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    int total = 0;
+
+    runner_backend = NULL;
+    trace_start(&runner_trace);
+
+    silence_stdout(1);
+
+    long long start = trace_now_ns();
+
+    for (int i = 0; i < count; i++)
+        run_test_file(BENCH_TREE, names[i], &total, &result.passed);
+
+    /* saving and comparing the baseline is part of what those modes cost */
+    if (runner_options.save_baseline || runner_options.compare_baseline)
+        finish_timings();
+
+    result.wall_ns = trace_now_ns() - start;
+
+    silence_stdout(0);
+
+    result.files = total;
+
+    for (int i = 0; i < runner_trace.count; i++)
+    {
+        TraceEvent *event = &runner_trace.events[i];
+
+        if (event->tid != TRACE_RUNNER_TRACK)
+            continue;
+
+        if (strcmp(event->name, "codegen") == 0)
+            result.codegen_ns += event->duration_ns;
+        else if (strcmp(event->name, "compile") == 0)
+        {
+            result.compile_ns += event->duration_ns;
+            result.compiled++;
+        }
+        else if (strcmp(event->name, "cache hit") == 0)
+            result.cache_ns += event->duration_ns;
+        else if (strcmp(event->name, "run") == 0)
+            result.run_ns += event->duration_ns;
+        else if (strcmp(event->name, "collect") == 0)
+            result.collect_ns += event->duration_ns;
+    }
+
+    trace_free(&runner_trace);
+    timing_results_free(&runner_results);
+    perf_results_free(&runner_perf);
+    runner_trace_tracks = 0;
+
+    return result;
+}
+
+
+/* =========================
+   REPORT
+========================= */
+
+void print_result(const BenchResult *result)
+{
+    char wall[32], codegen[32], compile[32], run[32];
+
+    format_duration(wall, sizeof(wall), (double)result->wall_ns);
+    format_duration(codegen, sizeof(codegen), (double)result->codegen_ns);
+    format_duration(compile, sizeof(compile), (double)result->compile_ns);
+    format_duration(run, sizeof(run), (double)result->run_ns);
+
+    double files_per_s = result->wall_ns > 0 ? (double)result->files * 1e9 / (double)result->wall_ns : 0.0;
+
+    printf("%-12s %12s %12s %12s %12s %8d %10.1f\n",
+           result->name, wall, codegen, compile, run, result->compiled, files_per_s);
+}
+
+void write_result(FILE *out, const BenchResult *result, const char *commit)
+{
+    JSON *json = json_acquire();
+
+    if (!json)
+        return;
+
+    json_add_literal(json, "scenario", result->name);
+    json_add_literal(json, "commit", commit);
+    json_add_literal(json, "timestamp", (long long)time(NULL));
+    json_add_literal(json, "files", bench_options.files);
+    json_add_literal(json, "functions", bench_options.functions);
+    json_add_literal(json, "depth", bench_options.depth);
+    json_add_literal(json, "wall_ns", result->wall_ns);
+    json_add_literal(json, "codegen_ns", result->codegen_ns);
+    json_add_literal(json, "compile_ns", result->compile_ns);
+    json_add_literal(json, "cache_ns", result->cache_ns);
+    json_add_literal(json, "run_ns", result->run_ns);
+    json_add_literal(json, "collect_ns", result->collect_ns);
+    json_add_literal(json, "compiled", result->compiled);
+    json_add_literal(json, "files_run", result->files);
+    json_add_literal(json, "files_passed", result->passed);
+    json_add_literal(json, "isolated", runner_isolation.enabled);
+
+    fprintf(out, "%s\n", json_stringify(json));
+
+    json_release(json);
+}
+
+
+/* =========================
+   MAIN
+========================= */
+
+int main(int argc, char *argv[])
+{
+    if (!bench_parse_args(argc, argv, &bench_options))
+        return 1;
+
+    ensure_build_dir();
+
+    if (runner_options.isolate && !configure_isolation())
+        return 1;
+
+    printf("🏗️  Generating %d files x %d functions, include depth %d in %s\n",
+           bench_options.files, bench_options.functions, bench_options.depth, BENCH_TREE);
+
+    if (!generate_tree(&bench_options))
+        return 1;
+
+    static char names[BENCH_MAX_FILES][64];
+    int count = list_tree(names, BENCH_MAX_FILES);
+
+    const RunnerOptions defaults = runner_options;
+    const char *commit = getenv("ASSERTX_BENCH_COMMIT");
+
+    FILE *out = fopen(bench_options.output, "a");
+
+    if (!out)
+    {
+        printf("❌ Cannot open %s\n", bench_options.output);
+        return 1;
+    }
+
+    printf("\n%-12s %12s %12s %12s %12s %8s %10s\n",
+           "Scenario", "Wall", "Codegen", "Compile", "Run", "Builds", "Files/s");
+
+    BenchResult results[24];
+    int n = 0;
+
+    results[n++] = bench_discover(100);
+    results[n++] = bench_extract(names, count);
+
+    runner_options = defaults;
+    write_leaf_header(bench_options.depth, 1);
+    results[n++] = bench_pipeline("test-cold", names, count);
+    results[n++] = bench_pipeline("test-warm", names, count);
+
+    runner_options = defaults;
+    runner_options.list = 1;
+    results[n++] = bench_pipeline("list", names, count);
+
+    runner_options = defaults;
+    runner_options.filter = "test_gen_1*";
+    results[n++] = bench_pipeline("filter", names, count);
+
+    runner_options = defaults;
+    runner_options.shuffle = 1;
+    runner_options.seed = "1";
+    results[n++] = bench_pipeline("shuffle", names, count);
+
+    runner_options = defaults;
+    runner_options.repeat = 4;
+    results[n++] = bench_pipeline("repeat", names, count);
+
+    runner_options = defaults;
+    runner_options.capture = capture_supported();
+    results[n++] = bench_pipeline("capture", names, count);
+
+    runner_options = defaults;
+    runner_options.perf_counters = 1;
+    results[n++] = bench_pipeline("perf", names, count);
+
+    if (shared_supported())
+    {
+        runner_options = defaults;
+        runner_options.shared = SHARED_IN_PROCESS;
+        results[n++] = bench_pipeline("shared-cold", names, count);
+        results[n++] = bench_pipeline("shared-warm", names, count);
+    }
+
+    runner_options = defaults;
+    runner_options.bench = 1;
+    runner_options.samples = 3;
+    write_leaf_header(bench_options.depth, 2);
+    results[n++] = bench_pipeline("bench-cold", names, count);
+    results[n++] = bench_pipeline("bench-warm", names, count);
+
+    runner_options.baseline_path = BENCH_BASELINE;
+    runner_options.save_baseline = 1;
+    results[n++] = bench_pipeline("save-baseline", names, count);
+
+    runner_options.save_baseline = 0;
+    runner_options.compare_baseline = 1;
+    results[n++] = bench_pipeline("baseline", names, count);
+
+    /* a fixed number of inputs, so the time measures the harness and not --fuzz-time */
+    if (compiler_select(defaults.compiler, PROFILE_DEBUG, 1))
+    {
+        runner_options = defaults;
+        runner_options.fuzz = 1;
+        runner_options.fuzz_runs = 1000;
+        results[n++] = bench_pipeline("fuzz-cold", names, count);
+        results[n++] = bench_pipeline("fuzz-warm", names, count);
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        print_result(&results[i]);
+        write_result(out, &results[i], commit ? commit : "unknown");
+    }
+
+    fclose(out);
+    json_pool_clear();
+
+    printf("\n💾 Results appended to %s\n", bench_options.output);
+
+    for (int i = 2; i < n; i++)
+    {
+        if (results[i].passed != results[i].files)
+        {
+            printf("❌ %s: only %d of %d files passed\n",
+                   results[i].name, results[i].passed, results[i].files);
+            return 1;
+        }
+    }
+
+    return 0;
+}
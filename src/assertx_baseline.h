@@ -0,0 +1,371 @@
+#ifndef ASSERTX_BASELINE_H
+#define ASSERTX_BASELINE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* only the duration formatting, so both sides print the same units */
+#define XASSERT_FORMAT_ONLY
+#include "../tests/xassert.h"
+#undef XASSERT_FORMAT_ONLY
+
+#define MAX_SAMPLES 64
+#define BASELINE_ALPHA 0.05
+
+
+/* =========================
+   STRUCTS
+========================= */
+
+typedef struct {
+    char kind[16];
+    char key[320];
+    int count;
+    long long samples[MAX_SAMPLES];
+} TimingResult;
+
+
+typedef struct {
+    TimingResult *items;
+    int count;
+    int capacity;
+} TimingResults;
+
+
+/* =========================
+   RESULTS
+========================= */
+
+TimingResult *timing_results_find(TimingResults *results, const char *key)
+{
+    for (int i = 0; i < results->count; i++)
+    {
+        if (strcmp(results->items[i].key, key) == 0)
+            return &results->items[i];
+    }
+
+    return NULL;
+}
+
+TimingResult *timing_results_put(TimingResults *results, const char *kind, const char *key)
+{
+    TimingResult *result = timing_results_find(results, key);
+
+    if (result)
+        return result;
+
+    if (results->count == results->capacity)
+    {
+        int capacity = results->capacity ? results->capacity * 2 : 32;
+        TimingResult *items = realloc(results->items, sizeof(TimingResult) * (size_t)capacity);
+
+        if (!items)
+            return NULL;
+
+        results->items = items;
+        results->capacity = capacity;
+    }
+
+    result = &results->items[results->count++];
+    memset(result, 0, sizeof(*result));
+
+    snprintf(result->kind, sizeof(result->kind), "%s", kind);
+    snprintf(result->key, sizeof(result->key), "%s", key);
+
+    return result;
+}
+
+void timing_results_free(TimingResults *results)
+{
+    free(results->items);
+
+    results->items = NULL;
+    results->count = 0;
+    results->capacity = 0;
+}
+
+/*
+ * Reads "<kind> <name> <n> <ns>..." lines. When prefix is given the
+ * key becomes "<prefix>:<name>", which is how a test binary's results
+ * are namespaced by their file.
+ */
+int timing_results_load(TimingResults *results, const char *path, const char *prefix)
+{
+    FILE *f = fopen(path, "r");
+
+    if (!f)
+        return 0;
+
+    char line[4096];
+    int loaded = 0;
+
+    while (fgets(line, sizeof(line), f))
+    {
+        char kind[16];
+        char name[256];
+        int count;
+        int offset;
+
+        if (line[0] == '#')
+            continue;
+
+        if (sscanf(line, "%15s %255s %d%n", kind, name, &count, &offset) != 3)
+            continue;
+
+        char key[320];
+
+        if (prefix)
+            snprintf(key, sizeof(key), "%s:%s", prefix, name);
+        else
+            snprintf(key, sizeof(key), "%s", name);
+
+        TimingResult *result = timing_results_put(results, kind, key);
+
+        if (!result)
+            break;
+
+        const char *cursor = line + offset;
+
+        result->count = 0;
+
+        for (int i = 0; i < count && result->count < MAX_SAMPLES; i++)
+        {
+            long long sample;
+            int consumed;
+
+            if (sscanf(cursor, "%lld%n", &sample, &consumed) != 1)
+                break;
+
+            result->samples[result->count++] = sample;
+            cursor += consumed;
+        }
+
+        loaded++;
+    }
+
+    fclose(f);
+
+    return loaded;
+}
+
+int timing_results_save(TimingResults *results, const char *path)
+{
+    /* keep entries from earlier runs that this run did not measure */
+    TimingResults merged = {0};
+
+    timing_results_load(&merged, path, NULL);
+
+    for (int i = 0; i < results->count; i++)
+    {
+        TimingResult *result = timing_results_put(&merged, results->items[i].kind, results->items[i].key);
+
+        if (result)
+            *result = results->items[i];
+    }
+
+    FILE *f = fopen(path, "w");
+
+    if (!f)
+    {
+        timing_results_free(&merged);
+        return 0;
+    }
+
+    fprintf(f, "# assertx baseline: <kind> <file:function> <samples> <ns>...\n");
+
+    for (int i = 0; i < merged.count; i++)
+    {
+        fprintf(f, "%s %s %d", merged.items[i].kind, merged.items[i].key, merged.items[i].count);
+
+        for (int j = 0; j < merged.items[i].count; j++)
+            fprintf(f, " %lld", merged.items[i].samples[j]);
+
+        fprintf(f, "\n");
+    }
+
+    fclose(f);
+    timing_results_free(&merged);
+
+    return 1;
+}
+
+
+/* =========================
+   STATISTICS
+========================= */
+
+int compare_long_long(const void *a, const void *b)
+{
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+double timing_median(const TimingResult *result)
+{
+    long long sorted[MAX_SAMPLES];
+
+    if (result->count == 0)
+        return 0.0;
+
+    memcpy(sorted, result->samples, sizeof(long long) * (size_t)result->count);
+    qsort(sorted, (size_t)result->count, sizeof(long long), compare_long_long);
+
+    if (result->count % 2)
+        return (double)sorted[result->count / 2];
+
+    return ((double)sorted[result->count / 2 - 1] + (double)sorted[result->count / 2]) / 2.0;
+}
+
+/*
+ * One-sided Mann-Whitney U test: probability of seeing a U at least
+ * this large if current and baseline come from the same distribution.
+ * The null distribution is computed exactly from the generating
+ * function prod_{k=1..n} (1 - q^(m+k)) / (1 - q^k), so small sample
+ * counts get exact p-values without needing libm.
+ */
+double mann_whitney_p(const TimingResult *current, const TimingResult *baseline)
+{
+    int n = current->count;
+    int m = baseline->count;
+
+    if (n == 0 || m == 0)
+        return 1.0;
+
+    /* 2U so ties (counted as 1/2) stay integral */
+    int u2 = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < m; j++)
+        {
+            if (current->samples[i] > baseline->samples[j])
+                u2 += 2;
+            else if (current->samples[i] == baseline->samples[j])
+                u2 += 1;
+        }
+    }
+
+    int max_u = n * m;
+    double *ways = calloc((size_t)max_u + 1, sizeof(double));
+
+    if (!ways)
+        return 1.0;
+
+    ways[0] = 1.0;
+
+    for (int k = 1; k <= n; k++)
+    {
+        for (int u = max_u; u >= m + k; u--)
+            ways[u] -= ways[u - m - k];
+
+        for (int u = k; u <= max_u; u++)
+            ways[u] += ways[u - k];
+    }
+
+    double total = 0.0;
+    double tail = 0.0;
+    int u_min = (u2 + 1) / 2;
+
+    for (int u = 0; u <= max_u; u++)
+    {
+        total += ways[u];
+
+        if (u >= u_min)
+            tail += ways[u];
+    }
+
+    free(ways);
+
+    return total > 0.0 ? tail / total : 1.0;
+}
+
+
+/* =========================
+   COMPARISON
+========================= */
+
+void format_duration(char *out, size_t size, double ns)
+{
+    __test_format_ns(out, size, ns);
+}
+
+/*
+ * Prints the functions whose median changed by more than threshold
+ * percent with a significant Mann-Whitney p-value and returns how
+ * many of them got slower.
+ */
+int timing_results_compare(TimingResults *current, TimingResults *baseline,
+                           double threshold)
+{
+    int regressed = 0;
+    int improved = 0;
+    int unchanged = 0;
+    int printed_header = 0;
+
+    for (int i = 0; i < current->count; i++)
+    {
+        TimingResult *now = &current->items[i];
+        TimingResult *before = timing_results_find(baseline, now->key);
+
+        if (!before || before->count == 0 || now->count == 0)
+            continue;
+
+        double base_median = timing_median(before);
+        double now_median = timing_median(now);
+
+        if (base_median <= 0.0)
+            continue;
+
+        double change = (now_median - base_median) / base_median * 100.0;
+        const char *verdict = NULL;
+        double p = 1.0;
+
+        if (change > threshold)
+        {
+            p = mann_whitney_p(now, before);
+            if (p < BASELINE_ALPHA)
+                verdict = "⚠️ regressed";
+        }
+        else if (change < -threshold)
+        {
+            p = mann_whitney_p(before, now);
+            if (p < BASELINE_ALPHA)
+                verdict = "🚀 improved";
+        }
+
+        if (!verdict)
+        {
+            unchanged++;
+            continue;
+        }
+
+        if (change > 0.0)
+            regressed++;
+        else
+            improved++;
+
+        if (!printed_header)
+        {
+            printf("%-44s %12s %12s %9s %7s\n", "Function", "Baseline", "Current", "Change", "p");
+            printed_header = 1;
+        }
+
+        char before_text[32];
+        char now_text[32];
+
+        format_duration(before_text, sizeof(before_text), base_median);
+        format_duration(now_text, sizeof(now_text), now_median);
+
+        printf("%-44s %12s %12s %+8.1f%% %7.4f  %s\n",
+               now->key, before_text, now_text, change, p, verdict);
+    }
+
+    printf("Regressed: %d | Improved: %d | Unchanged: %d\n",
+           regressed, improved, unchanged);
+
+    return regressed;
+}
+
+#endif
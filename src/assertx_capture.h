@@ -0,0 +1,227 @@
+#ifndef ASSERTX_CAPTURE_H
+#define ASSERTX_CAPTURE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#endif
+
+#define CAPTURE_RING_SIZE (1024 * 1024)
+#define CAPTURE_MAGIC 0x42525841u /* "AXRB" */
+
+
+/* =========================
+   RING LAYOUT
+========================= */
+
+/*
+ * Shared with xassert.h, which writes into the ring from the test
+ * process. Records are 8-byte aligned and never wrap: a PAD record
+ * fills the end of the ring instead. head and tail only grow, and the
+ * writer moves tail forward when it overwrites the oldest records.
+ */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t header_size;
+    uint64_t capacity;
+    uint64_t head;
+    uint64_t tail;
+    uint64_t overwritten;
+} CaptureHeader;
+
+
+typedef struct {
+    uint32_t size;
+    uint32_t type;
+    uint64_t length;
+} CaptureRecord;
+
+
+enum {
+    CAPTURE_PAD = 0,
+    CAPTURE_TEXT = 1,
+    CAPTURE_TEST_START = 2,
+    CAPTURE_TEST_END = 3,
+    CAPTURE_ASSERT_PASS = 4,
+    CAPTURE_ASSERT_FAIL = 5
+};
+
+
+typedef struct {
+    int fd;
+    size_t size;
+    CaptureHeader *header;
+} Capture;
+
+
+/* =========================
+   RUNNER SIDE
+========================= */
+
+int capture_supported(void)
+{
+#ifdef __linux__
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Creates the shared ring. The fd is close-on-exec, so compilers and
+ * other children never get it; capture_inherit() hands it on to the
+ * test process only.
+ */
+int capture_open(Capture *capture)
+{
+    capture->fd = -1;
+    capture->header = NULL;
+    capture->size = sizeof(CaptureHeader) + CAPTURE_RING_SIZE;
+
+#ifdef __linux__
+    int fd = (int)syscall(SYS_memfd_create, "assertx-capture", MFD_CLOEXEC);
+
+    if (fd < 0)
+        return 0;
+
+    if (ftruncate(fd, (off_t)capture->size) != 0)
+    {
+        close(fd);
+        return 0;
+    }
+
+    void *map = mmap(NULL, capture->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (map == MAP_FAILED)
+    {
+        close(fd);
+        return 0;
+    }
+
+    capture->fd = fd;
+    capture->header = map;
+
+    capture->header->magic = CAPTURE_MAGIC;
+    capture->header->header_size = sizeof(CaptureHeader);
+    capture->header->capacity = CAPTURE_RING_SIZE;
+
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/* called in the forked test process, before exec, to keep the ring fd open */
+void capture_inherit(int fd)
+{
+#ifdef __linux__
+    if (fd >= 0)
+        fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) & ~FD_CLOEXEC);
+#else
+    (void)fd;
+#endif
+}
+
+void capture_close(Capture *capture)
+{
+#ifdef __linux__
+    if (capture->header)
+        munmap(capture->header, capture->size);
+
+    if (capture->fd >= 0)
+        close(capture->fd);
+#endif
+
+    capture->header = NULL;
+    capture->fd = -1;
+}
+
+/*
+ * Replays the text the test wrote, in order, straight from the shared
+ * mapping, then reports what the structured events say. Works after
+ * the test process died because the ring lives in the memfd.
+ */
+void capture_report(Capture *capture, int crashed)
+{
+    CaptureHeader *header = capture->header;
+
+    if (!header)
+        return;
+
+    const char *data = (const char *)header + header->header_size;
+    uint64_t head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+
+    const char *current_test = NULL;
+    uint64_t current_test_len = 0;
+    const char *last_failure = NULL;
+    uint64_t last_failure_len = 0;
+    int passes = 0;
+    int failures = 0;
+
+    if (header->overwritten > 0)
+        printf("   ⚠️ %llu earlier records were overwritten in the capture ring\n",
+               (unsigned long long)header->overwritten);
+
+    for (uint64_t offset = header->tail; offset < head;)
+    {
+        const CaptureRecord *record = (const CaptureRecord *)(data + offset % header->capacity);
+        const char *payload = (const char *)(record + 1);
+
+        if (record->size == 0)
+            break;
+
+        switch (record->type)
+        {
+        case CAPTURE_TEXT:
+            fwrite(payload, 1, (size_t)record->length, stdout);
+            break;
+        case CAPTURE_TEST_START:
+            current_test = payload;
+            current_test_len = record->length;
+            break;
+        case CAPTURE_TEST_END:
+            current_test = NULL;
+            break;
+        case CAPTURE_ASSERT_PASS:
+            passes++;
+            break;
+        case CAPTURE_ASSERT_FAIL:
+            failures++;
+            last_failure = payload;
+            last_failure_len = record->length;
+            break;
+        default:
+            break;
+        }
+
+        offset += record->size;
+    }
+
+    fflush(stdout);
+
+    if (crashed && current_test)
+    {
+        printf("   💥 crashed inside %.*s", (int)current_test_len, current_test);
+
+        if (last_failure)
+            printf(" (last failed assertion: %.*s)", (int)last_failure_len, last_failure);
+
+        printf("\n");
+    }
+
+    printf("   📦 captured %d passed and %d failed assertions\n", passes, failures);
+}
+
+#endif
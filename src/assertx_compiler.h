@@ -0,0 +1,191 @@
+#ifndef ASSERTX_COMPILER_H
+#define ASSERTX_COMPILER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define COMPILER_NULL_REDIRECT "> NUL 2>&1"
+#else
+#define COMPILER_NULL_REDIRECT "> /dev/null 2>&1"
+#endif
+
+
+/* =========================
+   PROFILES
+========================= */
+
+typedef enum {
+    PROFILE_DEBUG = 0,
+    PROFILE_RELEASE = 1,
+    PROFILE_SANITIZE = 2,
+    PROFILE_COUNT = 3
+} BuildProfile;
+
+static const char *profile_names[PROFILE_COUNT] = {"debug", "release", "sanitize"};
+
+int profile_parse(const char *name, BuildProfile *profile)
+{
+    for (int i = 0; i < PROFILE_COUNT; i++)
+    {
+        if (strcmp(name, profile_names[i]) == 0)
+        {
+            *profile = (BuildProfile)i;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/* =========================
+   BACKENDS
+========================= */
+
+/*
+ * Flags are kept per backend because they do not translate one to one:
+ * tcc has no optimizer, no -Wextra and no sanitizers, but its -b bounds
+ * checker is the closest thing to the sanitize profile. A NULL
+ * fuzz_flags means the backend cannot build fuzz targets.
+ */
+
+typedef struct {
+    const char *name;
+    const char *command;
+    const char *warnings;
+    const char *profile_flags[PROFILE_COUNT];
+    const char *fuzz_flags;
+    const char *depfile_flags;
+} CompilerBackend;
+
+static const CompilerBackend compiler_backends[] = {
+    {"gcc", "gcc", "-Wall -Wextra",
+     {"-g", "-g -O2", "-g -O1 -fsanitize=address,undefined -fno-omit-frame-pointer"},
+     "-O1 -fsanitize-coverage=trace-pc", "-MMD -MF"},
+
+    {"clang", "clang", "-Wall -Wextra",
+     {"-g", "-g -O2", "-g -O1 -fsanitize=address,undefined -fno-omit-frame-pointer"},
+     "-O1 -fsanitize-coverage=trace-pc", "-MMD -MF"},
+
+    {"tcc", "tcc", "-Wall",
+     {"-g", "-g", "-g -b"},
+     NULL, "-MD -MF"},
+};
+
+#define COMPILER_BACKEND_COUNT ((int)(sizeof(compiler_backends) / sizeof(compiler_backends[0])))
+
+const CompilerBackend *compiler_find(const char *name)
+{
+    for (int i = 0; i < COMPILER_BACKEND_COUNT; i++)
+    {
+        if (strcmp(compiler_backends[i].name, name) == 0)
+            return &compiler_backends[i];
+    }
+
+    return NULL;
+}
+
+/* probes each backend once by asking it for its version */
+int compiler_available(const CompilerBackend *backend)
+{
+    static int probed[COMPILER_BACKEND_COUNT] = {0};
+    int index = (int)(backend - compiler_backends);
+
+    if (probed[index] == 0)
+    {
+        char command[128];
+
+        snprintf(command, sizeof(command), "%s -v %s", backend->command, COMPILER_NULL_REDIRECT);
+        probed[index] = system(command) == 0 ? 1 : -1;
+    }
+
+    return probed[index] > 0;
+}
+
+/*
+ * xassert.h marks its coverage hook no_sanitize_coverage, which gcc
+ * only understands from 12 on; older gcc instruments the hook itself
+ * and it recurses until the stack runs out. The preprocessor probe is
+ * cheap and also sees through "gcc" being clang on macOS.
+ */
+int compiler_fuzz_capable(const CompilerBackend *backend)
+{
+    static int probed[COMPILER_BACKEND_COUNT] = {0};
+    int index = (int)(backend - compiler_backends);
+
+    if (!backend->fuzz_flags)
+        return 0;
+
+    if (probed[index] == 0)
+    {
+#ifdef _WIN32
+        probed[index] = -1;
+#else
+        char command[256];
+
+        snprintf(command, sizeof(command),
+                 "printf '#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 12\\n"
+                 "#error\\n#endif\\n' | %s -E -x c - %s",
+                 backend->command, COMPILER_NULL_REDIRECT);
+        probed[index] = system(command) == 0 ? 1 : -1;
+#endif
+    }
+
+    return probed[index] > 0;
+}
+
+/*
+ * choice is a backend name, "auto" (gcc, then clang, then tcc) or
+ * "auto-fast", which takes tcc for plain debug builds, where compile
+ * time dominates, and falls back to "auto" for everything else.
+ * Returns NULL when nothing suitable is installed.
+ */
+const CompilerBackend *compiler_select(const char *choice, BuildProfile profile, int fuzz)
+{
+    if (strcmp(choice, "auto-fast") == 0)
+    {
+        const CompilerBackend *tcc = compiler_find("tcc");
+
+        if (profile == PROFILE_DEBUG && !fuzz && compiler_available(tcc))
+            return tcc;
+
+        choice = "auto";
+    }
+
+    if (strcmp(choice, "auto") == 0)
+    {
+        for (int i = 0; i < COMPILER_BACKEND_COUNT; i++)
+        {
+            if (!compiler_available(&compiler_backends[i]))
+                continue;
+
+            if (fuzz && !compiler_fuzz_capable(&compiler_backends[i]))
+                continue;
+
+            return &compiler_backends[i];
+        }
+
+        return NULL;
+    }
+
+    const CompilerBackend *backend = compiler_find(choice);
+
+    if (!backend || !compiler_available(backend))
+        return NULL;
+
+    if (fuzz && !compiler_fuzz_capable(backend))
+        return NULL;
+
+    return backend;
+}
+
+void compiler_flags(char *out, size_t size, const CompilerBackend *backend,
+                    BuildProfile profile, int fuzz)
+{
+    snprintf(out, size, "%s %s%s%s", backend->warnings, backend->profile_flags[profile],
+             fuzz ? " " : "", fuzz ? backend->fuzz_flags : "");
+}
+
+#endif
@@ -0,0 +1,348 @@
+#ifndef ASSERTX_ISOLATE_H
+#define ASSERTX_ISOLATE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#define ISOLATE_MAX_CPUS 1024
+#define CPUSET_WORD_BITS (8 * (int)sizeof(unsigned long))
+
+
+/* =========================
+   CPU SETS
+========================= */
+
+/*
+ * A plain bitmask handed straight to the sched_*affinity syscalls, so
+ * this works without _GNU_SOURCE being defined before the first
+ * include, which cpu_set_t would need.
+ */
+
+typedef struct {
+    unsigned long bits[ISOLATE_MAX_CPUS / (8 * sizeof(unsigned long))];
+} CpuSet;
+
+
+void cpuset_clear(CpuSet *set)
+{
+    memset(set, 0, sizeof(*set));
+}
+
+void cpuset_add(CpuSet *set, int cpu)
+{
+    if (cpu >= 0 && cpu < ISOLATE_MAX_CPUS)
+        set->bits[cpu / CPUSET_WORD_BITS] |= 1UL << (cpu % CPUSET_WORD_BITS);
+}
+
+void cpuset_remove(CpuSet *set, int cpu)
+{
+    if (cpu >= 0 && cpu < ISOLATE_MAX_CPUS)
+        set->bits[cpu / CPUSET_WORD_BITS] &= ~(1UL << (cpu % CPUSET_WORD_BITS));
+}
+
+int cpuset_has(const CpuSet *set, int cpu)
+{
+    if (cpu < 0 || cpu >= ISOLATE_MAX_CPUS)
+        return 0;
+
+    return (set->bits[cpu / CPUSET_WORD_BITS] >> (cpu % CPUSET_WORD_BITS)) & 1UL;
+}
+
+int cpuset_count(const CpuSet *set)
+{
+    int count = 0;
+
+    for (int cpu = 0; cpu < ISOLATE_MAX_CPUS; cpu++)
+        count += cpuset_has(set, cpu);
+
+    return count;
+}
+
+/* parses the kernel list format, "0-3,6"; returns 0 on malformed input */
+int cpuset_parse(const char *list, CpuSet *set)
+{
+    cpuset_clear(set);
+
+    const char *p = list;
+
+    while (*p && *p != '\n')
+    {
+        char *end;
+        long first = strtol(p, &end, 10);
+        long last = first;
+
+        if (end == p || first < 0 || first >= ISOLATE_MAX_CPUS)
+            return 0;
+
+        p = end;
+
+        if (*p == '-')
+        {
+            last = strtol(p + 1, &end, 10);
+
+            if (end == p + 1 || last < first || last >= ISOLATE_MAX_CPUS)
+                return 0;
+
+            p = end;
+        }
+
+        for (long cpu = first; cpu <= last; cpu++)
+            cpuset_add(set, (int)cpu);
+
+        if (*p == ',')
+            p++;
+        else if (*p && *p != '\n')
+            return 0;
+    }
+
+    return cpuset_count(set) > 0;
+}
+
+/* the inverse of cpuset_parse(), "-" for an empty set */
+void cpuset_format(const CpuSet *set, char *out, size_t size)
+{
+    size_t length = 0;
+
+    out[0] = '\0';
+
+    for (int cpu = 0; cpu < ISOLATE_MAX_CPUS && length < size; cpu++)
+    {
+        if (!cpuset_has(set, cpu))
+            continue;
+
+        int last = cpu;
+
+        while (last + 1 < ISOLATE_MAX_CPUS && cpuset_has(set, last + 1))
+            last++;
+
+        const char *separator = length ? "," : "";
+        int written = last > cpu
+                          ? snprintf(out + length, size - length, "%s%d-%d", separator, cpu, last)
+                          : snprintf(out + length, size - length, "%s%d", separator, cpu);
+
+        if (written < 0 || (size_t)written >= size - length)
+            break;
+
+        length += (size_t)written;
+        cpu = last;
+    }
+
+    if (length == 0)
+        snprintf(out, size, "-");
+}
+
+int isolate_supported(void)
+{
+#ifdef __linux__
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/* CPUs this process may run on */
+int cpuset_allowed(CpuSet *set)
+{
+    cpuset_clear(set);
+
+#ifdef __linux__
+    return syscall(SYS_sched_getaffinity, 0, sizeof(set->bits), set->bits) > 0;
+#else
+    return 0;
+#endif
+}
+
+/* pins the calling process; children started afterwards inherit the mask */
+int cpuset_pin(const CpuSet *set)
+{
+#ifdef __linux__
+    return syscall(SYS_sched_setaffinity, 0, sizeof(set->bits), set->bits) == 0;
+#else
+    (void)set;
+    return 0;
+#endif
+}
+
+
+/* =========================
+   TOPOLOGY
+========================= */
+
+/* reads a one-line sysfs file; returns 0 when it is missing */
+int isolate_read_sysfs(const char *path, char *out, size_t size)
+{
+    FILE *f = fopen(path, "r");
+
+    if (!f)
+        return 0;
+
+    int ok = fgets(out, (int)size, f) != NULL;
+
+    fclose(f);
+
+    if (ok)
+        out[strcspn(out, "\n")] = '\0';
+
+    return ok;
+}
+
+/* hardware threads sharing a core with cpu, cpu itself included */
+void cpu_siblings(int cpu, CpuSet *siblings)
+{
+    char path[128];
+    char list[256];
+
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+
+    if (!isolate_read_sysfs(path, list, sizeof(list)) || !cpuset_parse(list, siblings))
+        cpuset_clear(siblings);
+
+    cpuset_add(siblings, cpu);
+}
+
+
+/* =========================
+   PLAN
+========================= */
+
+typedef struct {
+    int enabled;
+    CpuSet tests;
+    CpuSet compile;
+    CpuSet idle;
+} Isolation;
+
+/*
+ * Splits the allowed CPUs in two: tests run on the requested CPUs (the
+ * highest allowed one by default), compiles on the rest. The SMT
+ * siblings of the test CPUs go to neither side while there are other
+ * CPUs left for the compiler, so nothing shares a core with a test.
+ * With a single CPU both sides get it. Returns 0 when none of the
+ * requested CPUs is allowed.
+ */
+int isolate_plan(Isolation *isolation, const CpuSet *allowed, const char *cpus)
+{
+    memset(isolation, 0, sizeof(*isolation));
+
+    if (cpus && *cpus)
+    {
+        CpuSet requested;
+
+        if (!cpuset_parse(cpus, &requested))
+            return 0;
+
+        for (int cpu = 0; cpu < ISOLATE_MAX_CPUS; cpu++)
+        {
+            if (cpuset_has(&requested, cpu) && cpuset_has(allowed, cpu))
+                cpuset_add(&isolation->tests, cpu);
+        }
+    }
+    else
+    {
+        for (int cpu = ISOLATE_MAX_CPUS - 1; cpu >= 0; cpu--)
+        {
+            if (cpuset_has(allowed, cpu))
+            {
+                cpuset_add(&isolation->tests, cpu);
+                break;
+            }
+        }
+    }
+
+    if (cpuset_count(&isolation->tests) == 0)
+        return 0;
+
+    isolation->compile = *allowed;
+
+    for (int cpu = 0; cpu < ISOLATE_MAX_CPUS; cpu++)
+    {
+        if (!cpuset_has(&isolation->tests, cpu))
+            continue;
+
+        CpuSet siblings;
+
+        cpu_siblings(cpu, &siblings);
+
+        for (int other = 0; other < ISOLATE_MAX_CPUS; other++)
+        {
+            if (cpuset_has(&siblings, other) && cpuset_has(allowed, other))
+            {
+                cpuset_remove(&isolation->compile, other);
+
+                if (!cpuset_has(&isolation->tests, other))
+                    cpuset_add(&isolation->idle, other);
+            }
+        }
+    }
+
+    /* no spare core: compiles take the siblings, then the test CPUs themselves */
+    if (cpuset_count(&isolation->compile) == 0)
+    {
+        isolation->compile = isolation->idle;
+        cpuset_clear(&isolation->idle);
+    }
+
+    if (cpuset_count(&isolation->compile) == 0)
+        isolation->compile = *allowed;
+
+    isolation->enabled = 1;
+
+    return 1;
+}
+
+/* frequency governor and SMT state, the usual sources of timing noise */
+void isolate_report(const Isolation *isolation)
+{
+    char tests[256];
+    char compile[256];
+    char idle[256];
+    char value[64];
+
+    cpuset_format(&isolation->tests, tests, sizeof(tests));
+    cpuset_format(&isolation->compile, compile, sizeof(compile));
+    cpuset_format(&isolation->idle, idle, sizeof(idle));
+
+    printf("📌 Tests on CPU %s, compiles on CPU %s\n", tests, compile);
+
+    if (cpuset_count(&isolation->idle) > 0)
+        printf("   SMT siblings left idle: CPU %s\n", idle);
+
+    if (memcmp(&isolation->tests, &isolation->compile, sizeof(CpuSet)) == 0)
+        printf("⚠️ Only CPU %s is available, tests and compiles share it\n", tests);
+
+    for (int cpu = 0; cpu < ISOLATE_MAX_CPUS; cpu++)
+    {
+        if (!cpuset_has(&isolation->tests, cpu))
+            continue;
+
+        char path[128];
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_governor", cpu);
+
+        if (!isolate_read_sysfs(path, value, sizeof(value)))
+            printf("   Governor: unknown on CPU %d (no cpufreq)\n", cpu);
+        else if (strcmp(value, "performance") == 0)
+            printf("   Governor: %s on CPU %d\n", value, cpu);
+        else
+            printf("⚠️ Governor: %s on CPU %d, timings may drift (performance is steadier)\n",
+                   value, cpu);
+    }
+
+    if (!isolate_read_sysfs("/sys/devices/system/cpu/smt/control", value, sizeof(value)))
+        printf("   SMT: unknown\n");
+    else if (strcmp(value, "notsupported") == 0 || strcmp(value, "notimplemented") == 0)
+        printf("   SMT: not supported\n");
+    else if (isolate_read_sysfs("/sys/devices/system/cpu/smt/active", value, sizeof(value)) &&
+             strcmp(value, "1") == 0)
+        printf("   SMT: on\n");
+    else
+        printf("   SMT: off\n");
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef ASSERTX_PERF_H
+#define ASSERTX_PERF_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json.h"
+
+#define PERF_COUNTERS 5
+
+
+/* =========================
+   STRUCTS
+========================= */
+
+typedef struct {
+    char key[320];
+    long long calls;
+    long long counts[PERF_COUNTERS];
+} PerfResult;
+
+
+typedef struct {
+    PerfResult *items;
+    int count;
+    int capacity;
+} PerfResults;
+
+
+static const char *perf_counter_names[PERF_COUNTERS] = {
+    "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses"};
+
+
+/* =========================
+   COLLECT
+========================= */
+
+/* reads "<name> <calls> <counter>..." lines written by xassert.h, -1 = unavailable */
+int perf_results_load(PerfResults *results, const char *path, const char *prefix)
+{
+    FILE *f = fopen(path, "r");
+
+    if (!f)
+        return 0;
+
+    char name[256];
+    long long calls;
+    long long counts[PERF_COUNTERS];
+    int loaded = 0;
+
+    while (fscanf(f, "%255s %lld %lld %lld %lld %lld %lld", name, &calls,
+                  &counts[0], &counts[1], &counts[2], &counts[3], &counts[4]) == 7)
+    {
+        if (results->count == results->capacity)
+        {
+            int capacity = results->capacity ? results->capacity * 2 : 32;
+            PerfResult *items = realloc(results->items, sizeof(PerfResult) * (size_t)capacity);
+
+            if (!items)
+                break;
+
+            results->items = items;
+            results->capacity = capacity;
+        }
+
+        PerfResult *result = &results->items[results->count++];
+
+        snprintf(result->key, sizeof(result->key), "%s:%s", prefix, name);
+        result->calls = calls;
+        memcpy(result->counts, counts, sizeof(counts));
+
+        loaded++;
+    }
+
+    fclose(f);
+
+    return loaded;
+}
+
+void perf_results_free(PerfResults *results)
+{
+    free(results->items);
+
+    results->items = NULL;
+    results->count = 0;
+    results->capacity = 0;
+}
+
+
+/* =========================
+   REPORT
+========================= */
+
+void format_count(char *out, size_t size, long long value)
+{
+    if (value < 0)
+        snprintf(out, size, "-");
+    else if (value < 10000)
+        snprintf(out, size, "%lld", value);
+    else if (value < 10000000)
+        snprintf(out, size, "%.1fk", (double)value / 1e3);
+    else if (value < 10000000000LL)
+        snprintf(out, size, "%.1fM", (double)value / 1e6);
+    else
+        snprintf(out, size, "%.1fG", (double)value / 1e9);
+}
+
+void perf_results_print(PerfResults *results)
+{
+    if (results->count == 0)
+        return;
+
+    printf("\n📈 Hardware counters (per call)\n");
+    printf("%-44s %9s %9s %6s %9s %9s %9s\n",
+           "Function", "Cycles", "Instr", "IPC", "Br-miss", "L1d-miss", "LLC-miss");
+
+    for (int i = 0; i < results->count; i++)
+    {
+        PerfResult *result = &results->items[i];
+        char text[PERF_COUNTERS][16];
+
+        for (int j = 0; j < PERF_COUNTERS; j++)
+            format_count(text[j], sizeof(text[j]), result->counts[j]);
+
+        char ipc[16] = "-";
+
+        if (result->counts[0] > 0 && result->counts[1] >= 0)
+            snprintf(ipc, sizeof(ipc), "%.2f", (double)result->counts[1] / (double)result->counts[0]);
+
+        printf("%-44s %9s %9s %6s %9s %9s %9s\n",
+               result->key, text[0], text[1], ipc, text[2], text[3], text[4]);
+    }
+}
+
+/* one JSON object per line, counters that were unavailable are null */
+int perf_results_write(PerfResults *results, const char *path)
+{
+    FILE *f = fopen(path, "w");
+
+    if (!f)
+        return 0;
+
+    for (int i = 0; i < results->count; i++)
+    {
+        PerfResult *result = &results->items[i];
+        JSON json = json_new();
+
+        json_add_string(&json, "function", result->key);
+        json_add_number_int(&json, "calls", result->calls);
+
+        for (int j = 0; j < PERF_COUNTERS; j++)
+        {
+            if (result->counts[j] < 0)
+                json_add_null(&json, perf_counter_names[j]);
+            else
+                json_add_number_int(&json, perf_counter_names[j], result->counts[j]);
+        }
+
+        fprintf(f, "%s\n", json_stringify(&json));
+    }
+
+    fclose(f);
+
+    return 1;
+}
+
+#endif
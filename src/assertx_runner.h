@@ -2,9 +2,19 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "assertx_baseline.h"
+#include "assertx_perf.h"
+#include "assertx_capture.h"
+#include "assertx_compiler.h"
+#include "assertx_trace.h"
+#include "assertx_shared.h"
+#include "assertx_isolate.h"
+
 #ifdef _WIN32
 #include <windows.h>
 #include <direct.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #define mkdir(path, mode) _mkdir(path)
 #define PATH_SEP "\\"
@@ -12,22 +22,129 @@
 #define fopen_safe(fp, path, mode) fopen_s(&(fp), path, mode)
 #define sscanf_safe sscanf_s
 #define strncpy_safe(dest, destsz, src) strncpy_s(dest, destsz, src, _TRUNCATE)
+#define setenv_safe(name, value) _putenv_s(name, value)
+#define unsetenv_safe(name) _putenv_s(name, "")
 
 #else
 #include <dirent.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 
 #define PATH_SEP "/"
 
 #define fopen_safe(fp, path, mode) ((fp) = fopen(path, mode)) == NULL
 #define sscanf_safe sscanf
 #define strncpy_safe(dest, destsz, src) strncpy(dest, src, destsz)
+#define setenv_safe(name, value) setenv(name, value, 1)
+#define unsetenv_safe(name) unsetenv(name)
 
 #endif
 
 #define BUILD_DIR "build"
-#define COMPILER "gcc"
-#define CFLAGS "-Wall -Wextra -g"
+#define MAX_FUNCTIONS 100
+#define FIXTURE_COUNT 4
+#define DEFAULT_SAMPLES 10
+#define DEFAULT_BASELINE BUILD_DIR "/assertx_baseline.txt"
+#define PERF_OUTPUT BUILD_DIR "/assertx_perf.jsonl"
+
+/* exit code used by xassert.h when a test function runs out of time */
+#define EXIT_TIMEOUT 124
+#define TIMEOUT_GRACE_SECONDS 2
+
+/* values of --shared */
+#define SHARED_OFF 0
+#define SHARED_IN_PROCESS 1
+#define SHARED_FORK 2
+
+
+/* =========================
+   OPTIONS
+========================= */
+
+typedef struct {
+    const char *dir_path;
+    int fuzz;
+    long fuzz_runs;
+    long fuzz_seconds;
+    int bench;
+    int samples;
+    const char *baseline_path;
+    int save_baseline;
+    int compare_baseline;
+    double regression_threshold;
+    int fail_on_regression;
+    int timeout;
+    long memory_mb;
+    long cpu_seconds;
+    int perf_counters;
+    int capture;
+    const char *filter;
+    int list;
+    const char *shard;
+    const char *trace_path;
+    const char *compiler;
+    const char *profile;
+    int repeat;
+    int shuffle;
+    const char *seed;
+    int shared;
+    int isolate;
+    const char *isolate_cpus;
+} RunnerOptions;
+
+static RunnerOptions runner_options = {
+    .dir_path = NULL,
+    .fuzz = 0,
+    .fuzz_runs = 0,
+    .fuzz_seconds = 10,
+    .bench = 0,
+    .samples = 0,
+    .baseline_path = DEFAULT_BASELINE,
+    .save_baseline = 0,
+    .compare_baseline = 0,
+    .regression_threshold = 10.0,
+    .fail_on_regression = 0,
+    .timeout = 0,
+    .memory_mb = 0,
+    .cpu_seconds = 0,
+    .perf_counters = 0,
+    .capture = 0,
+    .filter = NULL,
+    .list = 0,
+    .shard = NULL,
+    .trace_path = NULL,
+    .compiler = "auto",
+    .profile = NULL,
+    .repeat = 1,
+    .shuffle = 0,
+    .seed = NULL,
+    .shared = SHARED_OFF,
+    .isolate = 0,
+    .isolate_cpus = NULL,
+};
+
+/* timings collected from every test binary of this run */
+static TimingResults runner_results = {0};
+
+/* hardware counters collected with --perf-counters */
+static PerfResults runner_perf = {0};
+
+static int runner_timeouts = 0;
+
+/* spans recorded with --trace */
+static Trace runner_trace = {0};
+static int runner_trace_tracks = 0;
+
+/* picked once by configure_compiler() */
+static const CompilerBackend *runner_backend = NULL;
+static BuildProfile runner_profile = PROFILE_DEBUG;
+
+/* CPU split set up by configure_isolation() with --isolate */
+static Isolation runner_isolation = {0};
 
 
 /* =========================
@@ -43,11 +160,45 @@ void show_help(const char *program)
     printf("\n");
 
     printf("Usage:\n");
-    printf("  %s <test_directory>\n", program);
+    printf("  %s [options] <test_directory>\n", program);
     printf("\n");
 
     printf("Example:\n");
     printf("  %s ./tests\n", program);
+    printf("  %s --fuzz --fuzz-time=30 ./tests\n", program);
+    printf("\n");
+
+    printf("Options:\n");
+    printf("  --fuzz              Run fuzz_ functions instead of test_ functions\n");
+    printf("  --fuzz-runs=<n>     Stop each fuzz target after n executions\n");
+    printf("  --fuzz-time=<sec>   Stop each fuzz target after sec seconds (default 10)\n");
+    printf("  --bench             Run bench_ functions instead of test_ functions\n");
+    printf("  --samples=<n>       Timing samples per function (default %d when measuring)\n", DEFAULT_SAMPLES);
+    printf("  --save-baseline[=f] Store timings as the baseline (default %s)\n", DEFAULT_BASELINE);
+    printf("  --baseline[=f]      Compare timings against a stored baseline\n");
+    printf("  --threshold=<pct>   Slowdown that counts as a regression (default 10)\n");
+    printf("  --fail-on-regression  Exit with failure when a regression is found\n");
+    printf("  --timeout=<sec>     Time limit for each test function\n");
+    printf("                      (override with // assertx: timeout=<sec> above a function)\n");
+    printf("  --memory=<mb>       Address space limit for each test binary\n");
+    printf("  --cpu-time=<sec>    CPU time limit for each test binary\n");
+    printf("  --perf-counters     Count cycles, instructions and cache misses per function\n");
+    printf("                      (Linux perf_event_open, written to %s)\n", PERF_OUTPUT);
+    printf("  --capture           Collect test output through a shared memory ring (Linux)\n");
+    printf("  --filter=<glob>     Run only tests whose name matches (comma separated, * and ?)\n");
+    printf("  --list              List the tests of each file without running them\n");
+    printf("  --shard=<i>/<n>     Run only shard i (0-based) of n\n");
+    printf("  --trace=<file>      Write a Chrome trace of the run (chrome://tracing, Perfetto)\n");
+    printf("  --compiler=<name>   gcc, clang, tcc, auto (default) or auto-fast (tcc for debug builds)\n");
+    printf("  --profile=<name>    debug (default), release (default with --bench) or sanitize\n");
+    printf("  --repeat=<n>        Run every test n times in parallel and report flaky tests\n");
+    printf("  --shuffle           Run tests in a random order (each repetition its own)\n");
+    printf("  --seed=<n>          Base seed for --shuffle and test_seed()\n");
+    printf("  --shared[=fork]     Build tests as shared objects and run them inside the runner\n");
+    printf("                      (a crash ends the whole run; =fork gives each file its\n");
+    printf("                      own child process, Linux)\n");
+    printf("  --isolate[=<cpus>]  Pin tests to reserved CPUs (default: the last one) and\n");
+    printf("                      compiles to the others, e.g. --isolate=2-3 (Linux)\n");
     printf("\n");
 
     printf("Description:\n");
@@ -57,6 +208,112 @@ void show_help(const char *program)
 }
 
 
+/* =========================
+   ARGUMENTS
+========================= */
+
+int parse_args(int argc, char *argv[], RunnerOptions *options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+
+        if (strcmp(arg, "--fuzz") == 0)
+            options->fuzz = 1;
+        else if (strncmp(arg, "--fuzz-runs=", 12) == 0)
+            options->fuzz_runs = atol(arg + 12);
+        else if (strncmp(arg, "--fuzz-time=", 12) == 0)
+            options->fuzz_seconds = atol(arg + 12);
+        else if (strcmp(arg, "--bench") == 0)
+            options->bench = 1;
+        else if (strncmp(arg, "--samples=", 10) == 0)
+            options->samples = atoi(arg + 10);
+        else if (strcmp(arg, "--save-baseline") == 0)
+            options->save_baseline = 1;
+        else if (strncmp(arg, "--save-baseline=", 16) == 0)
+        {
+            options->save_baseline = 1;
+            options->baseline_path = arg + 16;
+        }
+        else if (strcmp(arg, "--baseline") == 0)
+            options->compare_baseline = 1;
+        else if (strncmp(arg, "--baseline=", 11) == 0)
+        {
+            options->compare_baseline = 1;
+            options->baseline_path = arg + 11;
+        }
+        else if (strncmp(arg, "--threshold=", 12) == 0)
+            options->regression_threshold = atof(arg + 12);
+        else if (strcmp(arg, "--fail-on-regression") == 0)
+            options->fail_on_regression = 1;
+        else if (strncmp(arg, "--timeout=", 10) == 0)
+            options->timeout = atoi(arg + 10);
+        else if (strncmp(arg, "--memory=", 9) == 0)
+            options->memory_mb = atol(arg + 9);
+        else if (strncmp(arg, "--cpu-time=", 11) == 0)
+            options->cpu_seconds = atol(arg + 11);
+        else if (strcmp(arg, "--perf-counters") == 0)
+            options->perf_counters = 1;
+        else if (strcmp(arg, "--capture") == 0)
+        {
+            options->capture = capture_supported();
+
+            if (!options->capture)
+                printf("⚠️ --capture needs Linux, output goes to the terminal\n");
+        }
+        else if (strncmp(arg, "--filter=", 9) == 0)
+            options->filter = arg + 9;
+        else if (strcmp(arg, "--list") == 0)
+            options->list = 1;
+        else if (strncmp(arg, "--shard=", 8) == 0)
+            options->shard = arg + 8;
+        else if (strncmp(arg, "--trace=", 8) == 0)
+            options->trace_path = arg + 8;
+        else if (strncmp(arg, "--compiler=", 11) == 0)
+            options->compiler = arg + 11;
+        else if (strncmp(arg, "--profile=", 10) == 0)
+            options->profile = arg + 10;
+        else if (strncmp(arg, "--repeat=", 9) == 0)
+            options->repeat = atoi(arg + 9) > 0 ? atoi(arg + 9) : 1;
+        else if (strcmp(arg, "--shuffle") == 0)
+            options->shuffle = 1;
+        else if (strncmp(arg, "--seed=", 7) == 0)
+            options->seed = arg + 7;
+        else if (strcmp(arg, "--shared") == 0 || strcmp(arg, "--shared=fork") == 0)
+        {
+            options->shared = arg[8] ? SHARED_FORK : SHARED_IN_PROCESS;
+
+            if (!shared_supported())
+            {
+                options->shared = SHARED_OFF;
+
+                if (shared_runner_static())
+                    printf("⚠️ --shared cannot dlopen from a statically linked assertx, building executables instead\n");
+                else
+                    printf("⚠️ --shared needs Linux, building executables instead\n");
+            }
+        }
+        else if (strcmp(arg, "--isolate") == 0 || strncmp(arg, "--isolate=", 10) == 0)
+        {
+            options->isolate = isolate_supported();
+            options->isolate_cpus = arg[9] ? arg + 10 : NULL;
+
+            if (!options->isolate)
+                printf("⚠️ --isolate needs Linux, tests are not pinned\n");
+        }
+        else if (strncmp(arg, "--", 2) == 0)
+        {
+            printf("❌ Unknown option: %s\n", arg);
+            return 0;
+        }
+        else
+            options->dir_path = arg;
+    }
+
+    return options->dir_path != NULL;
+}
+
+
 /* =========================
    UTILS
 ========================= */
@@ -86,24 +343,202 @@ void ensure_build_dir()
 #endif
 }
 
+void ensure_dir(const char *path)
+{
+    char partial[512];
+    size_t len = strlen(path);
+
+    if (len >= sizeof(partial))
+        return;
+
+    for (size_t i = 0; i <= len; i++)
+    {
+        if (i == len || path[i] == '/' || path[i] == '\\')
+        {
+            memcpy(partial, path, i);
+            partial[i] = '\0';
+
+            if (i > 0)
+                mkdir(partial, 0700);
+        }
+    }
+}
+
+
+/* returns 1 when both files exist and have the same bytes */
+int files_equal(const char *a_path, const char *b_path)
+{
+    FILE *a;
+    FILE *b;
+
+    if (fopen_safe(a, a_path, "rb"))
+        return 0;
+
+    if (fopen_safe(b, b_path, "rb"))
+    {
+        fclose(a);
+        return 0;
+    }
+
+    int equal = 1;
+    int ca;
+    int cb;
+
+    do
+    {
+        ca = fgetc(a);
+        cb = fgetc(b);
+
+        if (ca != cb)
+        {
+            equal = 0;
+            break;
+        }
+    } while (ca != EOF);
+
+    fclose(a);
+    fclose(b);
+
+    return equal;
+}
+
+long long file_mtime_ns(const char *path)
+{
+#ifdef _WIN32
+    struct _stat64 st;
+
+    if (_stat64(path, &st) != 0)
+        return -1;
+
+    return (long long)st.st_mtime * 1000000000LL;
+#elif defined(__APPLE__)
+    struct stat st;
+
+    if (stat(path, &st) != 0)
+        return -1;
+
+    return (long long)st.st_mtimespec.tv_sec * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+    struct stat st;
+
+    if (stat(path, &st) != 0)
+        return -1;
+
+    return (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+}
+
+/* returns 1 when the file uses XTEST() registration */
+int source_uses_xtest(const char *source_path)
+{
+    FILE *src;
+
+    if (fopen_safe(src, source_path, "r"))
+        return 0;
+
+    char line[512];
+    int found = 0;
+
+    while (!found && fgets(line, sizeof(line), src))
+    {
+        if (strncmp(line, "XTEST(", 6) == 0)
+            found = 1;
+    }
+
+    fclose(src);
+
+    return found;
+}
+
+
+/* =========================
+   BUILD CACHE
+========================= */
+
+/*
+ * A binary is reused when the generated runner did not change and it
+ * is newer than every file listed in the dependency file gcc wrote
+ * with -MMD. The runner embeds the compile command, so changing flags
+ * also forces a rebuild.
+ */
+int binary_up_to_date(const char *binary_path, const char *dep_path)
+{
+    long long built = file_mtime_ns(binary_path);
+
+    if (built < 0)
+        return 0;
+
+    FILE *deps;
+
+    if (fopen_safe(deps, dep_path, "r"))
+        return 0;
+
+    char word[1024];
+    int fresh = 1;
+    int skipped_target = 0;
+
+    while (fresh && fscanf(deps, "%1023s", word) == 1)
+    {
+        if (!skipped_target)
+        {
+            /* "build/__runner_x.o:" names the object, not a dependency */
+            if (ends_with(word, ":"))
+                skipped_target = 1;
+            continue;
+        }
+
+        if (strcmp(word, "\\") == 0)
+            continue;
+
+        long long changed = file_mtime_ns(word);
+
+        if (changed < 0 || changed >= built)
+            fresh = 0;
+    }
+
+    fclose(deps);
+
+    return fresh && skipped_target;
+}
+
+/* moves fresh_path over path unless the contents are identical; returns 1 when replaced */
+int replace_if_changed(const char *fresh_path, const char *path)
+{
+    if (files_equal(fresh_path, path))
+    {
+        remove(fresh_path);
+        return 0;
+    }
+
+    remove(path);
+    rename(fresh_path, path);
+
+    return 1;
+}
+
 
 /* =========================
    EXTRACT TEST FUNCTIONS
 ========================= */
 
-int extract_test_functions(const char *source_path, FILE *runner_file, char functions[][256])
+int extract_functions(const char *source_path, FILE *runner_file,
+                      const char *prefix, const char *params,
+                      char functions[][256])
 {
     FILE *src;
 
     if (fopen_safe(src, source_path, "r"))
         return 0;
 
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "void %s", prefix);
+
     char line[512];
     int count = 0;
 
     while (fgets(line, sizeof(line), src))
     {
-        if (strstr(line, "void test_") != NULL)
+        if (strstr(line, pattern) != NULL)
         {
             char func_name[256] = {0};
 
@@ -113,7 +548,7 @@ int extract_test_functions(const char *source_path, FILE *runner_file, char func
             if (sscanf_safe(line, "void %255[^ (]", func_name) == 1)
 #endif
             {
-                if (count < 100)
+                if (count < MAX_FUNCTIONS)
                 {
                     strncpy_safe(functions[count], sizeof(functions[count]), func_name);
 
@@ -121,7 +556,8 @@ int extract_test_functions(const char *source_path, FILE *runner_file, char func
                     functions[count][sizeof(functions[count]) - 1] = '\0';
 #endif
 
-                    fprintf(runner_file, "void %s();\n", functions[count]);
+                    if (runner_file)
+                        fprintf(runner_file, "void %s(%s);\n", functions[count], params);
 
                     count++;
                 }
@@ -134,128 +570,1202 @@ int extract_test_functions(const char *source_path, FILE *runner_file, char func
     return count;
 }
 
+/*
+ * Reads "assertx: timeout=<sec>" annotations placed on the line right
+ * above a function. Functions without one get the --timeout value.
+ */
+void extract_timeouts(const char *source_path, char functions[][256],
+                      int count, int timeouts[])
+{
+    for (int i = 0; i < count; i++)
+        timeouts[i] = runner_options.timeout;
 
-/* =========================
-   RUN TEST FILE
-========================= */
+    FILE *src;
 
-void run_test_file(const char *dir_path, const char *filename,
-                   int *total, int *passed)
-{
-    if (!ends_with(filename, "_test.c"))
+    if (fopen_safe(src, source_path, "r"))
         return;
 
-    (*total)++;
+    char line[512];
+    int pending = -1;
 
-    char source_path[512];
-    char binary_path[512];
-    char runner_path[512];
+    while (fgets(line, sizeof(line), src))
+    {
+        const char *annotation = strstr(line, "assertx: timeout=");
 
-    snprintf(source_path, sizeof(source_path),
-             "%s%s%s", dir_path, PATH_SEP, filename);
+        if (annotation)
+        {
+            pending = atoi(annotation + 17);
+            continue;
+        }
 
-    char test_name[256];
-    size_t name_len = strlen(filename);
+        if (pending >= 0 && strncmp(line, "void ", 5) == 0)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                size_t len = strlen(functions[i]);
 
-    if (name_len < 3)
-        return;
+                if (strncmp(line + 5, functions[i], len) == 0 &&
+                    (line[5 + len] == '(' || line[5 + len] == ' '))
+                    timeouts[i] = pending;
+            }
+        }
 
-    memcpy(test_name, filename, name_len - 2);
-    test_name[name_len - 2] = '\0';
+        pending = -1;
+    }
 
-#ifdef _WIN32
-    snprintf(binary_path, sizeof(binary_path),
-             "%s%s%s.exe", BUILD_DIR, PATH_SEP, test_name);
-#else
-    snprintf(binary_path, sizeof(binary_path),
-             "%s%s%s", BUILD_DIR, PATH_SEP, test_name);
-#endif
+    fclose(src);
+}
 
-    snprintf(runner_path, sizeof(runner_path),
-             "%s%s__runner_%s.c", BUILD_DIR, PATH_SEP, test_name);
+/* same order as the fields of __test_fixtures in xassert.h */
+static const char *fixture_names[FIXTURE_COUNT] = {
+    "setup_suite", "teardown_suite", "setup_each", "teardown_each"};
 
-    FILE *runner;
+/* flags which fixture functions the file defines and declares them in the runner */
+int extract_fixtures(const char *source_path, FILE *runner_file, int found[FIXTURE_COUNT])
+{
+    for (int i = 0; i < FIXTURE_COUNT; i++)
+        found[i] = 0;
+
+    FILE *src;
+
+    if (fopen_safe(src, source_path, "r"))
+        return 0;
+
+    char line[512];
+    int count = 0;
 
-    if (fopen_safe(runner, runner_path, "w"))
+    while (fgets(line, sizeof(line), src))
     {
-        printf("❌ Failed to create runner for %s\n", filename);
-        return;
-    }
+        const char *name = line;
 
-    fprintf(runner, "#include \"../%s\"\n\n", source_path);
+        if (strncmp(name, "static ", 7) == 0)
+            name += 7;
 
-    char functions[100][256];
+        if (strncmp(name, "void ", 5) != 0)
+            continue;
 
-    int test_count = extract_test_functions(source_path, runner, functions);
+        name += 5;
 
-    if (test_count == 0)
-    {
-        printf("⚠️ No test_ functions found in %s\n\n", filename);
+        for (int i = 0; i < FIXTURE_COUNT; i++)
+        {
+            size_t len = strlen(fixture_names[i]);
 
-        fclose(runner);
-        remove(runner_path);
+            if (!found[i] && strncmp(name, fixture_names[i], len) == 0 &&
+                (name[len] == '(' || name[len] == ' '))
+            {
+                found[i] = 1;
+                count++;
 
-        return;
+                if (runner_file)
+                    fprintf(runner_file, "void %s();\n", fixture_names[i]);
+            }
+        }
     }
 
-    fprintf(runner, "\nint main() {\n");
-    fprintf(runner, "    printf(\"Running %d tests...\\n\");\n", test_count);
+    fclose(src);
 
-    for (int i = 0; i < test_count; i++)
-    {
-        fprintf(runner, "    printf(\"→ %s\\n\");\n", functions[i]);
-        fprintf(runner, "    %s();\n", functions[i]);
-    }
+    return count;
+}
 
-    fprintf(runner, "    test_summary();\n");
-    fprintf(runner, "    return 0;\n");
-    fprintf(runner, "}\n");
+int extract_test_functions(const char *source_path, FILE *runner_file, char functions[][256])
+{
+    return extract_functions(source_path, runner_file, "test_", "", functions);
+}
 
-    fclose(runner);
+int extract_bench_functions(const char *source_path, FILE *runner_file, char functions[][256])
+{
+    return extract_functions(source_path, runner_file, "bench_", "", functions);
+}
+
+int extract_fuzz_functions(const char *source_path, FILE *runner_file, char functions[][256])
+{
+    return extract_functions(source_path, runner_file, "fuzz_",
+                             "const uint8_t *data, size_t len", functions);
+}
+
+
+/* =========================
+   COMPILER
+========================= */
 
-    printf("🔨 Compiling %s...\n", filename);
+int configure_compiler(void)
+{
+    runner_profile = runner_options.bench ? PROFILE_RELEASE : PROFILE_DEBUG;
 
-    int needed = snprintf(NULL, 0,
-                          "%s %s \"%s\" -o \"%s\"",
-                          COMPILER, CFLAGS, runner_path, binary_path);
+    if (runner_options.profile && !profile_parse(runner_options.profile, &runner_profile))
+    {
+        printf("❌ Unknown profile: %s\n", runner_options.profile);
+        return 0;
+    }
 
-    char *compile_cmd = malloc((size_t)needed + 1);
+    runner_backend = compiler_select(runner_options.compiler, runner_profile, runner_options.fuzz);
 
-    if (!compile_cmd)
+    if (!runner_backend)
     {
-        printf("❌ Memory allocation failed\n\n");
-        remove(runner_path);
-        return;
+        const CompilerBackend *wanted = compiler_find(runner_options.compiler);
+
+        if (wanted && !compiler_available(wanted))
+            printf("❌ %s is not installed\n", wanted->name);
+        else if (wanted && runner_options.fuzz && !wanted->fuzz_flags)
+            printf("❌ %s cannot build fuzz targets\n", wanted->name);
+        else if (wanted && runner_options.fuzz)
+            printf("❌ %s cannot build fuzz targets, gcc 12 or newer (or clang) is needed\n",
+                   wanted->name);
+        else if (runner_options.fuzz)
+            printf("❌ --fuzz needs gcc 12 or newer, or clang\n");
+        else
+            printf("❌ No usable compiler for --compiler=%s\n", runner_options.compiler);
+
+        return 0;
     }
 
-    snprintf(compile_cmd, (size_t)needed + 1,
-             "%s %s \"%s\" -o \"%s\"",
-             COMPILER, CFLAGS, runner_path, binary_path);
+    printf("🔧 Compiler: %s (%s)\n", runner_backend->name, profile_names[runner_profile]);
 
-    int compile_result = system(compile_cmd);
+    return 1;
+}
 
-    free(compile_cmd);
 
-    if (compile_result != 0)
-    {
-        printf("❌ Compile failed: %s\n\n", filename);
-        remove(runner_path);
-        return;
-    }
+/* =========================
+   ISOLATION
+========================= */
 
-    printf("▶️ Running %s...\n", filename);
+/*
+ * With --isolate the runner pins itself, and so every compiler it
+ * starts, to the compile CPUs, while test processes pin themselves to
+ * the reserved ones before running anything. ASSERTX_JOBS caps the
+ * parallel --repeat workers at the reserved CPU count, so with the
+ * default single CPU timed runs never overlap.
+ */
+int configure_isolation(void)
+{
+    CpuSet allowed;
 
-    if (system(binary_path) == 0)
+    if (!cpuset_allowed(&allowed))
     {
-        printf("✅ Passed: %s\n\n", filename);
-        (*passed)++;
+        printf("❌ Cannot read the CPU affinity of the runner\n");
+        return 0;
     }
-    else
+
+    if (!isolate_plan(&runner_isolation, &allowed, runner_options.isolate_cpus))
     {
-        printf("❌ Failed: %s\n\n", filename);
+        char list[256];
+
+        cpuset_format(&allowed, list, sizeof(list));
+        printf("❌ --isolate=%s names no usable CPU (allowed: %s)\n",
+               runner_options.isolate_cpus ? runner_options.isolate_cpus : "", list);
+        return 0;
     }
 
-    remove(runner_path);
-    remove(binary_path);
+    isolate_report(&runner_isolation);
+
+    if (!cpuset_pin(&runner_isolation.compile))
+        printf("⚠️ Could not pin the runner to its compile CPUs\n");
+
+    char jobs[16];
+
+    snprintf(jobs, sizeof(jobs), "%d", cpuset_count(&runner_isolation.tests));
+    setenv_safe("ASSERTX_JOBS", jobs);
+
+    return 1;
+}
+
+
+/* =========================
+   RUNNER GENERATION
+========================= */
+
+void write_fixtures(FILE *runner, const int fixtures[FIXTURE_COUNT])
+{
+    fprintf(runner, "\nstatic const __test_fixtures __test_file_fixtures = {");
+
+    for (int i = 0; i < FIXTURE_COUNT; i++)
+        fprintf(runner, "%s%s", i ? ", " : "", fixtures[i] ? fixture_names[i] : "NULL");
+
+    fprintf(runner, "};\n");
+}
+
+/*
+ * Scraped test_ functions become a table handed to __test_main(),
+ * which merges it with the XTEST() section and applies --filter,
+ * --list and --shard at run time, so none of them need a rebuild.
+ */
+void write_test_main(FILE *runner, char functions[][256], int count,
+                     const int timeouts[], const int fixtures[FIXTURE_COUNT])
+{
+    write_fixtures(runner, fixtures);
+
+    fprintf(runner, "\nstatic const __test_entry __test_table[] = {\n");
+
+    for (int i = 0; i < count; i++)
+        fprintf(runner, "    {\"%s\", %s, %d},\n", functions[i], functions[i], timeouts[i]);
+
+    if (count == 0)
+        fprintf(runner, "    {NULL, NULL, 0},\n");
+
+    fprintf(runner, "};\n");
+
+    fprintf(runner, "\nint main(int argc, char **argv) {\n");
+    fprintf(runner, "    __test_configure();\n");
+    fprintf(runner, "    return __test_main(argc, argv, __test_table, %d, &__test_file_fixtures);\n", count);
+    fprintf(runner, "}\n");
 }
 
+/*
+ * A --shared build has no main(): the runner resolves the test_
+ * functions itself and calls this entry point with the table.
+ */
+void write_shared_entry(FILE *runner, const int fixtures[FIXTURE_COUNT])
+{
+    write_fixtures(runner, fixtures);
+
+    fprintf(runner, "\nint %s(int argc, char **argv, const __test_entry *table, size_t count) {\n",
+            SHARED_ENTRY);
+    fprintf(runner, "    __test_configure();\n");
+    fprintf(runner, "    return __test_run_all(argc, argv, table, count, &__test_file_fixtures);\n");
+    fprintf(runner, "}\n");
+}
+
+void write_bench_main(FILE *runner, char functions[][256], int count,
+                      const int timeouts[], const int fixtures[FIXTURE_COUNT])
+{
+    write_fixtures(runner, fixtures);
+
+    fprintf(runner, "\nstatic const __test_entry __test_table[] = {\n");
+
+    for (int i = 0; i < count; i++)
+        fprintf(runner, "    {\"%s\", %s, %d},\n", functions[i], functions[i], timeouts[i]);
+
+    fprintf(runner, "};\n");
+
+    fprintf(runner, "\nint main(int argc, char **argv) {\n");
+    fprintf(runner, "    return __test_bench_main(argc, argv, __test_table, %d, &__test_file_fixtures);\n",
+            count);
+    fprintf(runner, "}\n");
+}
+
+void write_fuzz_main(FILE *runner, const char *test_name,
+                     char functions[][256], int count)
+{
+    fprintf(runner, "\nint main() {\n");
+    fprintf(runner, "    __test_configure();\n");
+    fprintf(runner, "    int failed = 0;\n");
+
+    for (int i = 0; i < count; i++)
+    {
+        char work_dir[512];
+        char corpus_dir[600];
+
+        snprintf(work_dir, sizeof(work_dir), "%s/fuzz/%s/%s",
+                 BUILD_DIR, test_name, functions[i]);
+        snprintf(corpus_dir, sizeof(corpus_dir), "%s/corpus", work_dir);
+
+        ensure_dir(corpus_dir);
+
+        fprintf(runner, "    failed |= __test_fuzz(\"%s\", %s, \"%s\", %ldL, %ldL);\n",
+                functions[i], functions[i], work_dir,
+                runner_options.fuzz_runs, runner_options.fuzz_seconds);
+    }
+
+    fprintf(runner, "    return failed;\n");
+    fprintf(runner, "}\n");
+}
+
+
+/* =========================
+   PROCESS
+========================= */
+
+typedef struct {
+    int exit_code;
+    int signal;
+    int timed_out;
+} RunStatus;
+
+/* the --capture ring of the file being run, -1 when none */
+static int runner_capture_fd = -1;
+
+#ifndef _WIN32
+/* the process group of the test binary being waited on, 0 when none */
+static volatile sig_atomic_t runner_child = 0;
+
+/*
+ * Test binaries leave the terminal's foreground group, so Ctrl-C only
+ * reaches the runner: take the running test group down with it.
+ */
+void runner_on_interrupt(int sig)
+{
+    if (runner_child > 0)
+        kill(-(pid_t)runner_child, SIGKILL);
+
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+#endif
+
+void install_interrupt_handlers(void)
+{
+#ifndef _WIN32
+    signal(SIGINT, runner_on_interrupt);
+    signal(SIGTERM, runner_on_interrupt);
+#endif
+}
+
+#ifndef _WIN32
+/* called in the child, before it runs any test code */
+void apply_limits(void)
+{
+    setpgid(0, 0);
+
+    /* a --shared child runs without exec, so it still has the runner's handlers */
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+
+    capture_inherit(runner_capture_fd);
+
+    if (runner_isolation.enabled)
+        cpuset_pin(&runner_isolation.tests);
+
+    if (runner_options.memory_mb > 0)
+    {
+        struct rlimit limit;
+        limit.rlim_cur = (rlim_t)runner_options.memory_mb * 1024 * 1024;
+        limit.rlim_max = limit.rlim_cur;
+        setrlimit(RLIMIT_AS, &limit);
+    }
+
+    if (runner_options.cpu_seconds > 0)
+    {
+        struct rlimit limit;
+        limit.rlim_cur = (rlim_t)runner_options.cpu_seconds;
+        limit.rlim_max = limit.rlim_cur + 1;
+        setrlimit(RLIMIT_CPU, &limit);
+    }
+}
+
+/*
+ * Waits for a child started with apply_limits(). When time_limit is
+ * positive the whole group is killed once it is exceeded, so a hung
+ * test cannot stall the run.
+ */
+RunStatus wait_child(pid_t pid, int time_limit)
+{
+    RunStatus status = {0, 0, 0};
+
+    setpgid(pid, pid);
+    runner_child = pid;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    long delay_us = 100;
+    int wstatus = 0;
+
+    for (;;)
+    {
+        pid_t done = waitpid(pid, &wstatus, time_limit > 0 ? WNOHANG : 0);
+
+        if (done == pid)
+            break;
+
+        if (done < 0)
+        {
+            runner_child = 0;
+            status.exit_code = -1;
+            return status;
+        }
+
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        long long elapsed_ms = (long long)(now.tv_sec - start.tv_sec) * 1000 +
+                               (now.tv_nsec - start.tv_nsec) / 1000000;
+
+        if (elapsed_ms >= (long long)time_limit * 1000)
+        {
+            kill(-pid, SIGKILL);
+            waitpid(pid, &wstatus, 0);
+            status.timed_out = 1;
+            break;
+        }
+
+        struct timespec pause = {0, delay_us * 1000};
+        nanosleep(&pause, NULL);
+
+        if (delay_us < 10000)
+            delay_us *= 2;
+    }
+
+    /* reap anything the test left behind in its group */
+    kill(-pid, SIGKILL);
+    runner_child = 0;
+
+    if (WIFEXITED(wstatus))
+        status.exit_code = WEXITSTATUS(wstatus);
+    else if (WIFSIGNALED(wstatus))
+    {
+        status.signal = WTERMSIG(wstatus);
+        status.exit_code = 128 + status.signal;
+
+        if (status.signal == SIGXCPU)
+            status.timed_out = 1;
+    }
+
+    if (status.exit_code == EXIT_TIMEOUT)
+        status.timed_out = 1;
+
+    return status;
+}
+#endif
+
+/* runs a test binary in its own process group with the configured resource limits */
+RunStatus run_binary(const char *binary_path, char *const args[], int time_limit)
+{
+    RunStatus status = {0, 0, 0};
+
+    fflush(stdout);
+
+#ifdef _WIN32
+    (void)time_limit;
+
+    char command[2048];
+    int length = snprintf(command, sizeof(command), "\"%s\"", binary_path);
+
+    for (int i = 0; args && args[i] && length < (int)sizeof(command); i++)
+        length += snprintf(command + length, sizeof(command) - (size_t)length, " \"%s\"", args[i]);
+
+    status.exit_code = system(command);
+#else
+    pid_t pid = fork();
+
+    if (pid < 0)
+    {
+        perror("fork");
+        status.exit_code = -1;
+        return status;
+    }
+
+    if (pid == 0)
+    {
+        apply_limits();
+
+        char *argv[16] = {(char *)binary_path};
+        int argc = 1;
+
+        for (int i = 0; args && args[i] && argc < 15; i++)
+            argv[argc++] = args[i];
+
+        argv[argc] = NULL;
+
+        execv(binary_path, argv);
+        perror("exec");
+        _exit(127);
+    }
+
+    status = wait_child(pid, time_limit);
+#endif
+
+    return status;
+}
+
+/* wall-clock budget for a whole binary, 0 when some function is unlimited */
+int file_time_limit(const int timeouts[], int count, int runs_per_function)
+{
+    int total = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (timeouts[i] <= 0)
+            return 0;
+
+        total += timeouts[i] * runs_per_function;
+    }
+
+    return total + TIMEOUT_GRACE_SECONDS;
+}
+
+
+/*
+ * Anything that has to outlive or police the tests keeps them out of
+ * the runner process: timeouts end with _exit(), resource limits and
+ * perf counters are per process and --capture replaces stdout.
+ */
+int shared_needs_fork(const int timeouts[], int count)
+{
+    if (runner_options.shared == SHARED_FORK || runner_options.memory_mb > 0 ||
+        runner_options.cpu_seconds > 0 || runner_options.perf_counters ||
+        runner_options.capture || runner_options.timeout > 0)
+        return 1;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (timeouts[i] > 0)
+            return 1;
+    }
+
+    return 0;
+}
+
+/*
+ * Keeps the ELF symbols that are also scraped void test_x() definitions,
+ * in ELF order, so an exported test_ helper taking arguments is never
+ * called without them. Returns the new count.
+ */
+int shared_keep_scraped(char names[][256], int count, char scraped[][256], int scraped_count)
+{
+    int kept = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        for (int j = 0; j < scraped_count; j++)
+        {
+            if (strcmp(names[i], scraped[j]) == 0)
+            {
+                if (kept != i)
+                    memcpy(names[kept], names[i], sizeof(names[kept]));
+
+                kept++;
+                break;
+            }
+        }
+    }
+
+    return kept;
+}
+
+/*
+ * Loads a --shared build and runs its test_ functions, found through
+ * the ELF dynamic symbol table, either right here or in a forked child
+ * that reuses the loaded image.
+ */
+RunStatus run_shared(const char *library_path, const char *source_path,
+                     char scraped[][256], int scraped_count,
+                     char *const args[], int runs_per_function)
+{
+    RunStatus status = {0, 0, 0};
+    char names[MAX_FUNCTIONS][256];
+    int timeouts[MAX_FUNCTIONS];
+    SharedTest table[MAX_FUNCTIONS];
+    SharedLibrary library;
+
+    int count = elf_test_symbols(library_path, names, MAX_FUNCTIONS);
+
+    if (count < 0)
+    {
+        printf("❌ Cannot read the symbol table of %s\n", library_path);
+        status.exit_code = -1;
+        return status;
+    }
+
+    count = shared_keep_scraped(names, count, scraped, scraped_count);
+
+    if (!shared_open(&library, library_path))
+    {
+        printf("❌ %s\n", shared_error());
+        status.exit_code = -1;
+        return status;
+    }
+
+    extract_timeouts(source_path, names, count, timeouts);
+
+    int resolved = shared_resolve(&library, names, timeouts, count, table);
+
+    char *argv[16] = {(char *)library_path};
+    int argc = 1;
+
+    for (int i = 0; args && args[i] && argc < 15; i++)
+        argv[argc++] = args[i];
+
+    argv[argc] = NULL;
+
+    fflush(stdout);
+
+#ifndef _WIN32
+    if (shared_needs_fork(timeouts, count))
+    {
+        pid_t pid = fork();
+
+        if (pid < 0)
+        {
+            perror("fork");
+            status.exit_code = -1;
+        }
+        else if (pid == 0)
+        {
+            apply_limits();
+            exit(library.entry(argc, argv, table, (size_t)resolved));
+        }
+        else
+        {
+            status = wait_child(pid, file_time_limit(timeouts, count, runs_per_function));
+        }
+
+        shared_close(&library);
+
+        return status;
+    }
+#else
+    (void)runs_per_function;
+#endif
+
+    if (runner_isolation.enabled)
+        cpuset_pin(&runner_isolation.tests);
+
+    status.exit_code = library.entry(argc, argv, table, (size_t)resolved);
+    fflush(stdout);
+
+    if (runner_isolation.enabled)
+        cpuset_pin(&runner_isolation.compile);
+
+    shared_close(&library);
+
+    return status;
+}
+
+
+/* runtime selection forwarded to test binaries; returns the argument count */
+int forwarded_args(char *args[], int max, char storage[][300])
+{
+    int count = 0;
+
+    if (runner_options.filter && count < max - 1)
+    {
+        snprintf(storage[count], 300, "--filter=%s", runner_options.filter);
+        args[count] = storage[count];
+        count++;
+    }
+
+    if (runner_options.shard && count < max - 1)
+    {
+        snprintf(storage[count], 300, "--shard=%s", runner_options.shard);
+        args[count] = storage[count];
+        count++;
+    }
+
+    if (runner_options.repeat > 1 && count < max - 1)
+    {
+        snprintf(storage[count], 300, "--repeat=%d", runner_options.repeat);
+        args[count] = storage[count];
+        count++;
+    }
+
+    if (runner_options.shuffle && count < max - 1)
+    {
+        snprintf(storage[count], 300, "--shuffle");
+        args[count] = storage[count];
+        count++;
+    }
+
+    if (runner_options.seed && count < max - 1)
+    {
+        snprintf(storage[count], 300, "--seed=%s", runner_options.seed);
+        args[count] = storage[count];
+        count++;
+    }
+
+    if (runner_options.list && count < max - 1)
+    {
+        snprintf(storage[count], 300, "--list");
+        args[count] = storage[count];
+        count++;
+    }
+
+    args[count] = NULL;
+
+    return count;
+}
+
+
+/*
+ * After a function timed out, the test binary leaves "<next> [<seed>]"
+ * in the resume file: the position to restart from and, for a shuffled
+ * run, the seed that reproduces its order. Replaces any earlier --start
+ * and --seed in args; returns 0 when there is nothing to resume.
+ */
+int resume_args(const char *resume_path, char *args[], int max, char storage[][300])
+{
+    FILE *f;
+
+    if (fopen_safe(f, resume_path, "r"))
+        return 0;
+
+    unsigned long long next = 0;
+    unsigned long long seed = 0;
+    int fields = fscanf(f, "%llu %llu", &next, &seed);
+
+    fclose(f);
+    remove(resume_path);
+
+    if (fields < 1)
+        return 0;
+
+    int count = 0;
+
+    for (int i = 0; args[i]; i++)
+    {
+        if (strncmp(args[i], "--start=", 8) != 0 && strncmp(args[i], "--seed=", 7) != 0)
+            args[count++] = args[i];
+    }
+
+    if (count >= max - 2)
+        return 0;
+
+    /* the kept args may point into storage, so the new ones go in its last slots */
+    snprintf(storage[max - 2], 300, "--start=%llu", next);
+    args[count++] = storage[max - 2];
+
+    if (fields == 2 && count < max - 1)
+    {
+        snprintf(storage[max - 1], 300, "--seed=%llu", seed);
+        args[count++] = storage[max - 1];
+    }
+
+    args[count] = NULL;
+
+    return 1;
+}
+
+
+/* =========================
+   TIMINGS
+========================= */
+
+int effective_samples(void)
+{
+    if (runner_options.samples > 0)
+        return runner_options.samples < MAX_SAMPLES ? runner_options.samples : MAX_SAMPLES;
+
+    if (runner_options.bench || runner_options.save_baseline || runner_options.compare_baseline)
+        return DEFAULT_SAMPLES;
+
+    return 1;
+}
+
+/* returns the number of regressions found against the stored baseline */
+int finish_timings(void)
+{
+    int regressions = 0;
+
+    if (runner_options.compare_baseline)
+    {
+        TimingResults baseline = {0};
+
+        printf("\n📊 Comparing against %s\n", runner_options.baseline_path);
+
+        if (timing_results_load(&baseline, runner_options.baseline_path, NULL) == 0)
+            printf("⚠️ No baseline found, run with --save-baseline first\n");
+        else
+            regressions = timing_results_compare(&runner_results, &baseline,
+                                                 runner_options.regression_threshold);
+
+        timing_results_free(&baseline);
+    }
+
+    if (runner_options.save_baseline)
+    {
+        if (timing_results_save(&runner_results, runner_options.baseline_path))
+            printf("💾 Baseline saved to %s\n", runner_options.baseline_path);
+        else
+            printf("❌ Failed to save baseline to %s\n", runner_options.baseline_path);
+    }
+
+    timing_results_free(&runner_results);
+
+    if (runner_perf.count > 0)
+    {
+        perf_results_print(&runner_perf);
+
+        if (perf_results_write(&runner_perf, PERF_OUTPUT))
+            printf("💾 Counters saved to %s\n", PERF_OUTPUT);
+    }
+
+    perf_results_free(&runner_perf);
+
+    return regressions;
+}
+
+
+void finish_trace(void)
+{
+    if (!runner_trace.enabled)
+        return;
+
+    if (trace_write(&runner_trace, runner_options.trace_path))
+        printf("🧵 Trace saved to %s\n", runner_options.trace_path);
+    else
+        printf("❌ Failed to write trace to %s\n", runner_options.trace_path);
+
+    trace_free(&runner_trace);
+    json_pool_clear();
+}
+
+
+/* =========================
+   RUN TEST FILE
+========================= */
+
+void run_test_file(const char *dir_path, const char *filename,
+                   int *total, int *passed)
+{
+    if (!ends_with(filename, "_test.c"))
+        return;
+
+    char source_path[512];
+    char binary_path[512];
+    char runner_path[512];
+    char fresh_path[520];
+    char dep_path[512];
+
+    snprintf(source_path, sizeof(source_path),
+             "%s%s%s", dir_path, PATH_SEP, filename);
+
+    char test_name[256];
+    size_t name_len = strlen(filename);
+
+    if (name_len < 3)
+        return;
+
+    memcpy(test_name, filename, name_len - 2);
+    test_name[name_len - 2] = '\0';
+
+    if (!runner_backend && !configure_compiler())
+        return;
+
+    /*
+     * Each mode, backend and profile builds its own binary, so switching
+     * between them keeps every cached build around. --capture compiles
+     * the file with _GNU_SOURCE, so it gets its own variant too.
+     */
+    int shared = runner_options.shared && !runner_options.fuzz && !runner_options.bench;
+    const char *mode = runner_options.fuzz    ? "fuzz"
+                       : runner_options.bench ? "bench"
+                       : shared               ? "shared"
+                                              : "test";
+    char variant[64];
+
+    snprintf(variant, sizeof(variant), "%s%s.%s-%s",
+             mode, runner_options.capture ? "-capture" : "",
+             runner_backend->name, profile_names[runner_profile]);
+
+#ifdef _WIN32
+    snprintf(binary_path, sizeof(binary_path),
+             "%s%s%s.%s.exe", BUILD_DIR, PATH_SEP, test_name, variant);
+#else
+    snprintf(binary_path, sizeof(binary_path),
+             "%s%s%s.%s%s", BUILD_DIR, PATH_SEP, test_name, variant, shared ? ".so" : "");
+#endif
+
+    snprintf(runner_path, sizeof(runner_path),
+             "%s%s__runner_%s.%s.c", BUILD_DIR, PATH_SEP, test_name, variant);
+    snprintf(fresh_path, sizeof(fresh_path), "%s.new", runner_path);
+    snprintf(dep_path, sizeof(dep_path),
+             "%s%s%s.%s.d", BUILD_DIR, PATH_SEP, test_name, variant);
+
+    char flags[256];
+
+    compiler_flags(flags, sizeof(flags), runner_backend, runner_profile, runner_options.fuzz);
+
+    if (shared)
+        strncat(flags, " -shared -fPIC", sizeof(flags) - strlen(flags) - 1);
+
+    long long phase_start = trace_now_ns();
+
+    FILE *runner;
+
+    if (fopen_safe(runner, fresh_path, "w"))
+    {
+        (*total)++;
+        printf("❌ Failed to create runner for %s\n", filename);
+        return;
+    }
+
+    fprintf(runner, "/* assertx: %s %s */\n", runner_backend->command, flags);
+
+    /* xassert.h swaps stdout for a ring-backed stream through fopencookie() */
+    if (runner_options.capture)
+        fprintf(runner, "#define _GNU_SOURCE\n");
+
+    fprintf(runner, "#include \"../%s\"\n\n", source_path);
+
+    char functions[MAX_FUNCTIONS][256];
+    int timeouts[MAX_FUNCTIONS];
+    int fixtures[FIXTURE_COUNT] = {0};
+    int test_count = 0;
+    int time_limit = 0;
+
+    if (runner_options.fuzz)
+    {
+        int fuzz_count = extract_fuzz_functions(source_path, runner, functions);
+
+        /* files without fuzz targets are not part of a fuzz run */
+        if (fuzz_count == 0)
+        {
+            fclose(runner);
+            remove(fresh_path);
+            return;
+        }
+
+        write_fuzz_main(runner, test_name, functions, fuzz_count);
+
+        if (runner_options.timeout > 0)
+            time_limit = (int)runner_options.fuzz_seconds * fuzz_count + runner_options.timeout;
+    }
+    else if (runner_options.bench)
+    {
+        int bench_count = extract_bench_functions(source_path, runner, functions);
+
+        if (bench_count == 0)
+        {
+            fclose(runner);
+            remove(fresh_path);
+            return;
+        }
+
+        extract_timeouts(source_path, functions, bench_count, timeouts);
+        extract_fixtures(source_path, runner, fixtures);
+        write_bench_main(runner, functions, bench_count, timeouts, fixtures);
+
+        time_limit = file_time_limit(timeouts, bench_count, effective_samples() + 1);
+    }
+    else
+    {
+        test_count = extract_test_functions(source_path, runner, functions);
+
+        if (test_count == 0 && !source_uses_xtest(source_path))
+        {
+            (*total)++;
+            printf("⚠️ No test_ functions found in %s\n\n", filename);
+
+            fclose(runner);
+            remove(fresh_path);
+
+            return;
+        }
+
+        extract_timeouts(source_path, functions, test_count, timeouts);
+        extract_fixtures(source_path, runner, fixtures);
+
+        if (shared)
+            write_shared_entry(runner, fixtures);
+        else
+            write_test_main(runner, functions, test_count, timeouts, fixtures);
+
+        /* XTEST() functions are not known here, so only the default timeout bounds them */
+        if (test_count > 0)
+            time_limit = file_time_limit(timeouts, test_count,
+                                         runner_options.repeat > 1 ? runner_options.repeat
+                                                                   : effective_samples());
+    }
+
+    (*total)++;
+
+    fclose(runner);
+
+    int changed = replace_if_changed(fresh_path, runner_path);
+
+    trace_span(&runner_trace, "runner", "codegen", filename, TRACE_RUNNER_TRACK,
+               phase_start, trace_now_ns());
+    phase_start = trace_now_ns();
+
+    if (!changed && binary_up_to_date(binary_path, dep_path))
+    {
+        printf("⚡ Up to date: %s\n", filename);
+
+        trace_span(&runner_trace, "runner", "cache hit", filename, TRACE_RUNNER_TRACK,
+                   phase_start, trace_now_ns());
+    }
+    else
+    {
+        printf("🔨 Compiling %s...\n", filename);
+
+        const char *format = "%s %s %s \"%s\" \"%s\" -o \"%s\"";
+
+        int needed = snprintf(NULL, 0, format, runner_backend->command, flags,
+                              runner_backend->depfile_flags, dep_path, runner_path, binary_path);
+
+        char *compile_cmd = malloc((size_t)needed + 1);
+
+        if (!compile_cmd)
+        {
+            printf("❌ Memory allocation failed\n\n");
+            remove(runner_path);
+            return;
+        }
+
+        snprintf(compile_cmd, (size_t)needed + 1, format, runner_backend->command, flags,
+                 runner_backend->depfile_flags, dep_path, runner_path, binary_path);
+
+        int compile_result = system(compile_cmd);
+
+        free(compile_cmd);
+
+        trace_span(&runner_trace, "runner", "compile", filename, TRACE_RUNNER_TRACK,
+                   phase_start, trace_now_ns());
+
+        if (compile_result != 0)
+        {
+            printf("❌ Compile failed: %s\n\n", filename);
+            /* forget the runner so the next run retries the build */
+            remove(runner_path);
+            return;
+        }
+    }
+
+    if (!runner_options.list)
+        printf(runner_options.fuzz ? "🐛 Fuzzing %s...\n" : "▶️ Running %s...\n", filename);
+
+    char results_path[512];
+    char samples[16];
+    char default_timeout[16];
+
+    snprintf(results_path, sizeof(results_path),
+             "%s%s%s.results", BUILD_DIR, PATH_SEP, test_name);
+    snprintf(samples, sizeof(samples), "%d", effective_samples());
+    snprintf(default_timeout, sizeof(default_timeout), "%d", runner_options.timeout);
+
+    char resume_path[512];
+
+    snprintf(resume_path, sizeof(resume_path),
+             "%s%s%s.resume", BUILD_DIR, PATH_SEP, test_name);
+
+    remove(results_path);
+    remove(resume_path);
+    setenv_safe("ASSERTX_RESULTS", results_path);
+    setenv_safe("ASSERTX_RESUME", resume_path);
+    setenv_safe("ASSERTX_SAMPLES", samples);
+    setenv_safe("ASSERTX_TIMEOUT", default_timeout);
+
+    char trace_path[512];
+    int track = 0;
+
+    snprintf(trace_path, sizeof(trace_path),
+             "%s%s%s.trace", BUILD_DIR, PATH_SEP, test_name);
+
+    if (runner_trace.enabled)
+    {
+        track = ++runner_trace_tracks;
+        trace_name_track(&runner_trace, track, filename);
+
+        remove(trace_path);
+        setenv_safe("ASSERTX_TRACE", trace_path);
+    }
+
+    char perf_path[512];
+
+    snprintf(perf_path, sizeof(perf_path),
+             "%s%s%s.perf", BUILD_DIR, PATH_SEP, test_name);
+
+    if (runner_options.perf_counters)
+    {
+        remove(perf_path);
+        setenv_safe("ASSERTX_PERF", perf_path);
+    }
+
+    Capture capture = {-1, 0, NULL};
+
+    if (runner_options.capture && capture_open(&capture))
+    {
+        char fd_text[16];
+        snprintf(fd_text, sizeof(fd_text), "%d", capture.fd);
+        setenv_safe("ASSERTX_CAPTURE_FD", fd_text);
+        runner_capture_fd = capture.fd;
+    }
+
+    /* two spare slots for the --start and --seed of a resumed run */
+    char *args[10];
+    char arg_storage[10][300];
+
+    if (runner_options.bench && runner_options.filter)
+    {
+        /* benchmarks take --filter only */
+        snprintf(arg_storage[0], sizeof(arg_storage[0]), "--filter=%s", runner_options.filter);
+        args[0] = arg_storage[0];
+        args[1] = NULL;
+    }
+    else if (!runner_options.fuzz && !runner_options.bench)
+        forwarded_args(args, 8, arg_storage);
+    else
+        args[0] = NULL;
+
+    phase_start = trace_now_ns();
+
+    RunStatus status;
+    int timed_out = 0;
+
+    for (int resumes = 0;; resumes++)
+    {
+        status = shared ? run_shared(binary_path, source_path, functions, test_count, args,
+                                     runner_options.repeat > 1 ? runner_options.repeat
+                                                               : effective_samples())
+                        : run_binary(binary_path, args, time_limit);
+
+        timed_out |= status.timed_out;
+
+        if (!status.timed_out || resumes >= MAX_FUNCTIONS ||
+            !resume_args(resume_path, args, 10, arg_storage))
+            break;
+
+        printf("↪️ Resuming %s after the timed out test\n", filename);
+
+        /* each run rewrites the trace file */
+        if (runner_trace.enabled)
+        {
+            trace_load(&runner_trace, trace_path, track);
+            remove(trace_path);
+        }
+    }
+
+    status.timed_out = timed_out;
+    remove(resume_path);
+    unsetenv_safe("ASSERTX_RESUME");
+
+    trace_span(&runner_trace, "runner", "run", filename, TRACE_RUNNER_TRACK,
+               phase_start, trace_now_ns());
+    phase_start = trace_now_ns();
+
+    if (capture.header)
+    {
+        capture_report(&capture, status.signal != 0 || status.timed_out);
+        capture_close(&capture);
+
+        /* later runs in this process must not pick up a closed fd */
+        runner_capture_fd = -1;
+        unsetenv_safe("ASSERTX_CAPTURE_FD");
+    }
+
+    timing_results_load(&runner_results, results_path, test_name);
+    remove(results_path);
+
+    if (runner_options.perf_counters)
+    {
+        perf_results_load(&runner_perf, perf_path, test_name);
+        remove(perf_path);
+    }
+
+    if (runner_trace.enabled)
+    {
+        trace_load(&runner_trace, trace_path, track);
+        remove(trace_path);
+    }
+
+    trace_span(&runner_trace, "runner", "collect", filename, TRACE_RUNNER_TRACK,
+               phase_start, trace_now_ns());
+
+    if (status.timed_out)
+    {
+        printf("⏱️ Timed out: %s\n\n", filename);
+        runner_timeouts++;
+    }
+    else if (status.exit_code == 0)
+    {
+        printf("✅ Passed: %s\n\n", filename);
+        (*passed)++;
+    }
+    else if (status.signal)
+    {
+        printf("💥 Crashed: %s (signal %d)\n\n", filename, status.signal);
+    }
+    else
+    {
+        printf("❌ Failed: %s\n\n", filename);
+    }
+}
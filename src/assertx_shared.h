@@ -0,0 +1,269 @@
+#ifndef ASSERTX_SHARED_H
+#define ASSERTX_SHARED_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <dlfcn.h>
+#include <elf.h>
+#include <link.h>
+#include <sys/auxv.h>
+#endif
+
+/* exported by the generated runner of a --shared build */
+#define SHARED_ENTRY "assertx_shared_main"
+
+
+/* =========================
+   STRUCTS
+========================= */
+
+/* same layout as __test_entry in xassert.h */
+typedef struct {
+    const char *name;
+    void (*fn)(void);
+    int timeout;
+} SharedTest;
+
+
+typedef int (*SharedEntry)(int argc, char **argv, const SharedTest *table, size_t count);
+
+
+typedef struct {
+    void *handle;
+    SharedEntry entry;
+} SharedLibrary;
+
+
+/* a -static runner has no dynamic loader, so AT_BASE stays 0 */
+int shared_runner_static(void)
+{
+#ifdef __linux__
+    return getauxval(AT_BASE) == 0;
+#else
+    return 0;
+#endif
+}
+
+int shared_supported(void)
+{
+#ifdef __linux__
+    return !shared_runner_static();
+#else
+    return 0;
+#endif
+}
+
+
+/* =========================
+   ELF SYMBOLS
+========================= */
+
+/*
+ * Lists the defined, default-visibility functions named test_* in the
+ * dynamic symbol table of a shared object, in address order, which is
+ * the order the compiler laid them out in the source. Returns -1 when
+ * the file cannot be read or is not a native ELF object.
+ */
+int elf_test_symbols(const char *path, char names[][256], int max)
+{
+#ifdef __linux__
+    FILE *f = fopen(path, "rb");
+
+    if (!f)
+        return -1;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    if (size < (long)sizeof(ElfW(Ehdr)))
+    {
+        fclose(f);
+        return -1;
+    }
+
+    unsigned char *image = malloc((size_t)size);
+    unsigned long long *addresses = malloc(sizeof(unsigned long long) * (size_t)(max > 0 ? max : 1));
+
+    if (!image || !addresses || fread(image, 1, (size_t)size, f) != (size_t)size)
+    {
+        free(image);
+        free(addresses);
+        fclose(f);
+        return -1;
+    }
+
+    fclose(f);
+
+    const ElfW(Ehdr) *header = (const ElfW(Ehdr) *)image;
+    const ElfW(Shdr) *sections = NULL;
+    int count = -1;
+
+    if (memcmp(header->e_ident, ELFMAG, SELFMAG) != 0 ||
+        header->e_ident[EI_CLASS] != (__ELF_NATIVE_CLASS == 64 ? ELFCLASS64 : ELFCLASS32) ||
+        header->e_shentsize != sizeof(ElfW(Shdr)) ||
+        header->e_shoff > (unsigned long)size ||
+        (unsigned long)header->e_shnum * sizeof(ElfW(Shdr)) > (unsigned long)size - header->e_shoff)
+        goto done;
+
+    sections = (const ElfW(Shdr) *)(image + header->e_shoff);
+    count = 0;
+
+    for (int s = 0; s < header->e_shnum; s++)
+    {
+        const ElfW(Shdr) *symtab = &sections[s];
+
+        if (symtab->sh_type != SHT_DYNSYM || symtab->sh_entsize != sizeof(ElfW(Sym)) ||
+            symtab->sh_link >= header->e_shnum)
+            continue;
+
+        const ElfW(Shdr) *strtab = &sections[symtab->sh_link];
+
+        if (symtab->sh_offset > (unsigned long)size ||
+            symtab->sh_size > (unsigned long)size - symtab->sh_offset ||
+            strtab->sh_offset > (unsigned long)size ||
+            strtab->sh_size > (unsigned long)size - strtab->sh_offset)
+            continue;
+
+        const ElfW(Sym) *symbols = (const ElfW(Sym) *)(image + symtab->sh_offset);
+        const char *strings = (const char *)(image + strtab->sh_offset);
+        size_t symbol_count = symtab->sh_size / sizeof(ElfW(Sym));
+
+        for (size_t i = 0; i < symbol_count && count < max; i++)
+        {
+            /* the ELF64_ST_* macros decode st_info the same way for both classes */
+            const ElfW(Sym) *symbol = &symbols[i];
+            int binding = ELF64_ST_BIND(symbol->st_info);
+
+            if (ELF64_ST_TYPE(symbol->st_info) != STT_FUNC || symbol->st_shndx == SHN_UNDEF ||
+                (binding != STB_GLOBAL && binding != STB_WEAK) ||
+                ELF64_ST_VISIBILITY(symbol->st_other) != STV_DEFAULT ||
+                symbol->st_name >= strtab->sh_size)
+                continue;
+
+            const char *name = strings + symbol->st_name;
+            size_t room = strtab->sh_size - symbol->st_name;
+            size_t length = strnlen(name, room);
+
+            if (length == room || length >= 256 || strncmp(name, "test_", 5) != 0)
+                continue;
+
+            /* insertion sort by address, there are at most max entries */
+            int at = count;
+
+            while (at > 0 && addresses[at - 1] > symbol->st_value)
+            {
+                memcpy(names[at], names[at - 1], 256);
+                addresses[at] = addresses[at - 1];
+                at--;
+            }
+
+            memcpy(names[at], name, length + 1);
+            addresses[at] = symbol->st_value;
+            count++;
+        }
+    }
+
+done:
+    free(image);
+    free(addresses);
+
+    return count;
+#else
+    (void)path;
+    (void)names;
+    (void)max;
+    return -1;
+#endif
+}
+
+
+/* =========================
+   LOADING
+========================= */
+
+/* RTLD_LOCAL keeps the xassert.h globals of each test file apart */
+int shared_open(SharedLibrary *library, const char *path)
+{
+    library->handle = NULL;
+    library->entry = NULL;
+
+#ifdef __linux__
+    library->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+
+    if (!library->handle)
+        return 0;
+
+    *(void **)&library->entry = dlsym(library->handle, SHARED_ENTRY);
+
+    if (!library->entry)
+    {
+        dlclose(library->handle);
+        library->handle = NULL;
+        return 0;
+    }
+
+    return 1;
+#else
+    (void)path;
+    return 0;
+#endif
+}
+
+const char *shared_error(void)
+{
+#ifdef __linux__
+    const char *error = dlerror();
+
+    return error ? error : "unknown dlopen error";
+#else
+    return "shared objects need Linux";
+#endif
+}
+
+/* fills table with the functions that resolve; returns how many did */
+int shared_resolve(SharedLibrary *library, char names[][256], const int timeouts[],
+                   int count, SharedTest table[])
+{
+    int resolved = 0;
+
+#ifdef __linux__
+    for (int i = 0; i < count; i++)
+    {
+        void *symbol = dlsym(library->handle, names[i]);
+
+        if (!symbol)
+            continue;
+
+        table[resolved].name = names[i];
+        *(void **)&table[resolved].fn = symbol;
+        table[resolved].timeout = timeouts[i];
+        resolved++;
+    }
+#else
+    (void)library;
+    (void)names;
+    (void)timeouts;
+    (void)count;
+    (void)table;
+#endif
+
+    return resolved;
+}
+
+/* dlclose() also runs the atexit() handlers the test file registered */
+void shared_close(SharedLibrary *library)
+{
+#ifdef __linux__
+    if (library->handle)
+        dlclose(library->handle);
+#endif
+
+    library->handle = NULL;
+    library->entry = NULL;
+}
+
+#endif
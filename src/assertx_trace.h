@@ -0,0 +1,251 @@
+#ifndef ASSERTX_TRACE_H
+#define ASSERTX_TRACE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "json.h"
+
+/* track of the runner itself, test binaries get 1, 2, ... */
+#define TRACE_RUNNER_TRACK 0
+
+
+/* =========================
+   STRUCTS
+========================= */
+
+typedef struct {
+    char name[128];
+    char cat[16];
+    char detail[128];
+    int tid;
+    long long start_ns;
+    long long duration_ns;
+} TraceEvent;
+
+
+typedef struct {
+    int tid;
+    char name[128];
+} TraceTrack;
+
+
+typedef struct {
+    int enabled;
+    long long origin_ns;
+    TraceEvent *events;
+    int count;
+    int capacity;
+    TraceTrack *tracks;
+    int track_count;
+    int track_capacity;
+} Trace;
+
+
+/* =========================
+   RECORD
+========================= */
+
+/* same clock as __test_now_ns() in xassert.h, so spans from both line up */
+long long trace_now_ns(void)
+{
+    struct timespec ts;
+#ifdef _WIN32
+    timespec_get(&ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void trace_start(Trace *trace)
+{
+    trace->enabled = 1;
+    trace->origin_ns = trace_now_ns();
+}
+
+/* events are only buffered here, trace_write() does all the formatting */
+void trace_span(Trace *trace, const char *cat, const char *name, const char *detail,
+                int tid, long long start_ns, long long end_ns)
+{
+    if (!trace->enabled)
+        return;
+
+    if (trace->count == trace->capacity)
+    {
+        int capacity = trace->capacity ? trace->capacity * 2 : 256;
+        TraceEvent *events = realloc(trace->events, sizeof(TraceEvent) * (size_t)capacity);
+
+        if (!events)
+            return;
+
+        trace->events = events;
+        trace->capacity = capacity;
+    }
+
+    TraceEvent *event = &trace->events[trace->count++];
+
+    snprintf(event->name, sizeof(event->name), "%s", name);
+    snprintf(event->cat, sizeof(event->cat), "%s", cat);
+    snprintf(event->detail, sizeof(event->detail), "%s", detail ? detail : "");
+    event->tid = tid;
+    event->start_ns = start_ns;
+    event->duration_ns = end_ns - start_ns;
+}
+
+void trace_name_track(Trace *trace, int tid, const char *name)
+{
+    if (!trace->enabled)
+        return;
+
+    if (trace->track_count == trace->track_capacity)
+    {
+        int capacity = trace->track_capacity ? trace->track_capacity * 2 : 16;
+        TraceTrack *tracks = realloc(trace->tracks, sizeof(TraceTrack) * (size_t)capacity);
+
+        if (!tracks)
+            return;
+
+        trace->tracks = tracks;
+        trace->track_capacity = capacity;
+    }
+
+    TraceTrack *track = &trace->tracks[trace->track_count++];
+
+    track->tid = tid;
+    snprintf(track->name, sizeof(track->name), "%s", name);
+}
+
+/* reads the "<start> <duration> <name>" lines a test binary wrote at exit */
+int trace_load(Trace *trace, const char *path, int tid)
+{
+    if (!trace->enabled)
+        return 0;
+
+    FILE *f = fopen(path, "r");
+
+    if (!f)
+        return 0;
+
+    char line[512];
+    int loaded = 0;
+
+    while (fgets(line, sizeof(line), f))
+    {
+        long long start;
+        long long duration;
+        char name[256];
+
+        if (line[0] == '#')
+            continue;
+
+        if (sscanf(line, "%lld %lld %255s", &start, &duration, name) != 3)
+            continue;
+
+        trace_span(trace, "test", name, NULL, tid, start, start + duration);
+        loaded++;
+    }
+
+    fclose(f);
+
+    return loaded;
+}
+
+void trace_free(Trace *trace)
+{
+    free(trace->events);
+    free(trace->tracks);
+
+    memset(trace, 0, sizeof(*trace));
+}
+
+
+/* =========================
+   EXPORT
+========================= */
+
+/*
+ * Writes the Chrome Trace Event format (JSON object form), which
+ * chrome://tracing and ui.perfetto.dev both load. Timestamps are
+ * microseconds since the runner started.
+ */
+int trace_write(Trace *trace, const char *path)
+{
+    FILE *f = fopen(path, "w");
+
+    if (!f)
+        return 0;
+
+    JSON *json = json_acquire();
+    JSON *args = json_acquire();
+
+    if (!json || !args)
+    {
+        json_release(json);
+        json_release(args);
+        fclose(f);
+        return 0;
+    }
+
+    fprintf(f, "{\"traceEvents\":[\n");
+
+    json_add_literal(json, "name", "process_name");
+    json_add_literal(json, "ph", "M");
+    json_add_literal(json, "pid", 1);
+    json_add_literal(json, "tid", TRACE_RUNNER_TRACK);
+    json_add_literal(args, "name", "assertx");
+    json_add_object(json, "args", args);
+
+    fprintf(f, "%s", json_stringify(json));
+
+    for (int i = 0; i < trace->track_count; i++)
+    {
+        json_reset(json);
+        json_reset(args);
+
+        json_add_literal(json, "name", "thread_name");
+        json_add_literal(json, "ph", "M");
+        json_add_literal(json, "pid", 1);
+        json_add_literal(json, "tid", trace->tracks[i].tid);
+        json_add_literal(args, "name", (const char *)trace->tracks[i].name);
+        json_add_object(json, "args", args);
+
+        fprintf(f, ",\n%s", json_stringify(json));
+    }
+
+    for (int i = 0; i < trace->count; i++)
+    {
+        TraceEvent *event = &trace->events[i];
+
+        json_reset(json);
+
+        json_add_literal(json, "name", (const char *)event->name);
+        json_add_literal(json, "cat", (const char *)event->cat);
+        json_add_literal(json, "ph", "X");
+        json_add_literal(json, "ts", (event->start_ns - trace->origin_ns) / 1000);
+        json_add_literal(json, "dur", event->duration_ns / 1000);
+        json_add_literal(json, "pid", 1);
+        json_add_literal(json, "tid", event->tid);
+
+        if (event->detail[0])
+        {
+            json_reset(args);
+            json_add_literal(args, "file", (const char *)event->detail);
+            json_add_object(json, "args", args);
+        }
+
+        fprintf(f, ",\n%s", json_stringify(json));
+    }
+
+    fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    json_release(json);
+    json_release(args);
+    fclose(f);
+
+    return 1;
+}
+
+#endif
@@ -98,6 +98,138 @@ static inline void json_array_appendf(JSONArray *arr, const char *fmt, ...)
 }
 
 
+/* =========================
+   INTERNAL RAW APPEND
+========================= */
+
+static inline void json_buffer_append(char *buffer, size_t *length, const char *data, size_t len)
+{
+    if (*length >= JSON_BUFFER_SIZE - 1)
+        return;
+
+    size_t remaining = JSON_BUFFER_SIZE - 1 - *length;
+
+    if (len > remaining)
+        len = remaining;
+
+    memcpy(buffer + *length, data, len);
+
+    *length += len;
+    buffer[*length] = '\0';
+}
+
+
+/* appends value as a quoted JSON string, escaping quotes, backslashes and control characters */
+static inline void json_buffer_append_escaped(char *buffer, size_t *length, const char *value)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    json_buffer_append(buffer, length, "\"", 1);
+
+    const char *span = value;
+    const char *p = value;
+
+    for (;; p++)
+    {
+        unsigned char c = (unsigned char)*p;
+
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        json_buffer_append(buffer, length, span, (size_t)(p - span));
+
+        if (c == '\0')
+            break;
+
+        char escape[6] = {'\\', (char)c, 0, 0, 0, 0};
+        size_t escape_len = 2;
+
+        switch (c)
+        {
+        case '"':
+        case '\\':
+            break;
+        case '\n':
+            escape[1] = 'n';
+            break;
+        case '\r':
+            escape[1] = 'r';
+            break;
+        case '\t':
+            escape[1] = 't';
+            break;
+        case '\b':
+            escape[1] = 'b';
+            break;
+        case '\f':
+            escape[1] = 'f';
+            break;
+        default:
+            escape[1] = 'u';
+            escape[2] = '0';
+            escape[3] = '0';
+            escape[4] = hex[c >> 4];
+            escape[5] = hex[c & 0xf];
+            escape_len = 6;
+            break;
+        }
+
+        json_buffer_append(buffer, length, escape, escape_len);
+        span = p + 1;
+    }
+
+    json_buffer_append(buffer, length, "\"", 1);
+}
+
+
+/* formats value into out (at least 21 bytes) and returns the digit count */
+static inline size_t json_format_int(char *out, long long value)
+{
+    static const char digits[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    char tmp[24];
+    char *end = tmp + sizeof(tmp);
+    char *p = end;
+
+    unsigned long long v = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+
+    while (v >= 100)
+    {
+        unsigned idx = (unsigned)(v % 100) * 2;
+        v /= 100;
+        *--p = digits[idx + 1];
+        *--p = digits[idx];
+    }
+
+    if (v >= 10)
+    {
+        unsigned idx = (unsigned)v * 2;
+        *--p = digits[idx + 1];
+        *--p = digits[idx];
+    }
+    else
+        *--p = (char)('0' + v);
+
+    if (value < 0)
+        *--p = '-';
+
+    size_t len = (size_t)(end - p);
+    memcpy(out, p, len);
+
+    return len;
+}
+
+
+static inline void json_buffer_append_int(char *buffer, size_t *length, long long value)
+{
+    char digits[24];
+    json_buffer_append(buffer, length, digits, json_format_int(digits, value));
+}
+
+
 /* =========================
    COMMA HELPERS
 ========================= */
@@ -130,16 +262,33 @@ static inline void json_array_add_comma(JSONArray *arr)
    INIT
 ========================= */
 
+static inline void json_reset(JSON *json)
+{
+    json->buffer[0] = '{';
+    json->buffer[1] = '\0';
+
+    json->length = 1;
+    json->count = 0;
+    json->closed = false;
+}
+
+
+static inline void json_array_reset(JSONArray *arr)
+{
+    arr->buffer[0] = '[';
+    arr->buffer[1] = '\0';
+
+    arr->length = 1;
+    arr->count = 0;
+    arr->closed = false;
+}
+
+
 static inline JSON json_new()
 {
     JSON json;
 
-    json.buffer[0] = '{';
-    json.buffer[1] = '\0';
-
-    json.length = 1;
-    json.count = 0;
-    json.closed = false;
+    json_reset(&json);
 
     return json;
 }
@@ -149,53 +298,171 @@ static inline JSONArray json_array_new()
 {
     JSONArray arr;
 
-    arr.buffer[0] = '[';
-    arr.buffer[1] = '\0';
-
-    arr.length = 1;
-    arr.count = 0;
-    arr.closed = false;
+    json_array_reset(&arr);
 
     return arr;
 }
 
 
+/* =========================
+   BUILDER POOL
+========================= */
+
+/*
+ * Each thread keeps up to JSON_POOL_SIZE released builders and hands
+ * the most recently released one back first, so steady-state emission
+ * allocates nothing and reuses memory that is still in cache. Call
+ * json_pool_clear() before a thread exits to free its builders.
+ */
+
+#ifndef JSON_POOL_SIZE
+#define JSON_POOL_SIZE 8
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define JSON_THREAD_LOCAL __declspec(thread)
+#else
+#define JSON_THREAD_LOCAL _Thread_local
+#endif
+
+static JSON_THREAD_LOCAL JSON *json_pool_free[JSON_POOL_SIZE];
+static JSON_THREAD_LOCAL int json_pool_count = 0;
+
+
+static inline JSON *json_acquire(void)
+{
+    JSON *json = json_pool_count > 0
+                     ? json_pool_free[--json_pool_count]
+                     : (JSON *)malloc(sizeof(JSON));
+
+    if (json)
+        json_reset(json);
+
+    return json;
+}
+
+
+static inline void json_release(JSON *json)
+{
+    if (!json)
+        return;
+
+    if (json_pool_count < JSON_POOL_SIZE)
+        json_pool_free[json_pool_count++] = json;
+    else
+        free(json);
+}
+
+
+static inline void json_pool_clear(void)
+{
+    while (json_pool_count > 0)
+        free(json_pool_free[--json_pool_count]);
+}
+
+
 /* =========================
    JSON ADD FUNCTIONS
 ========================= */
 
+static inline void json_append_key(JSON *json, const char *key)
+{
+    json_buffer_append_escaped(json->buffer, &json->length, key);
+    json_buffer_append(json->buffer, &json->length, ":", 1);
+}
+
+
 static inline void json_add_string(JSON *json, const char *key, const char *value)
 {
     json_add_comma(json);
-    json_appendf(json, "\"%s\":\"%s\"", key, value);
+    json_append_key(json, key);
+    json_buffer_append_escaped(json->buffer, &json->length, value);
 }
 
 
 static inline void json_add_bool(JSON *json, const char *key, _Bool value)
 {
     json_add_comma(json);
-    json_appendf(json, "\"%s\":%s", key, value ? "true" : "false");
+    json_append_key(json, key);
+    json_buffer_append(json->buffer, &json->length, value ? "true" : "false", value ? 4 : 5);
 }
 
 
 static inline void json_add_null(JSON *json, const char *key)
 {
     json_add_comma(json);
-    json_appendf(json, "\"%s\":null", key);
+    json_append_key(json, key);
+    json_buffer_append(json->buffer, &json->length, "null", 4);
 }
 
 
 static inline void json_add_number_int(JSON *json, const char *key, long long value)
 {
     json_add_comma(json);
-    json_appendf(json, "\"%s\":%lld", key, value);
+    json_append_key(json, key);
+    json_buffer_append_int(json->buffer, &json->length, value);
 }
 
 
 static inline void json_add_number_double(JSON *json, const char *key, double value)
 {
     json_add_comma(json);
-    json_appendf(json, "\"%s\":%g", key, value);
+    json_append_key(json, key);
+    json_appendf(json, "%g", value);
+}
+
+
+/* =========================
+   JSON ADD WITH LITERAL KEYS
+========================= */
+
+/*
+ * The json_put_* functions take a key that is already quoted and
+ * followed by ':', so adding a field is a single memcpy of the key.
+ * Use them through json_add_literal(), which builds that key from a
+ * string literal at compile time. Literal keys are not escaped.
+ */
+
+#define JSON_QUOTED_KEY(key) "\"" key "\":"
+
+
+static inline void json_put_string(JSON *json, const char *quoted_key, size_t key_len, const char *value)
+{
+    json_add_comma(json);
+    json_buffer_append(json->buffer, &json->length, quoted_key, key_len);
+    json_buffer_append_escaped(json->buffer, &json->length, value);
+}
+
+
+static inline void json_put_bool(JSON *json, const char *quoted_key, size_t key_len, _Bool value)
+{
+    json_add_comma(json);
+    json_buffer_append(json->buffer, &json->length, quoted_key, key_len);
+    json_buffer_append(json->buffer, &json->length, value ? "true" : "false", value ? 4 : 5);
+}
+
+
+static inline void json_put_number_int(JSON *json, const char *quoted_key, size_t key_len, long long value)
+{
+    json_add_comma(json);
+    json_buffer_append(json->buffer, &json->length, quoted_key, key_len);
+    json_buffer_append_int(json->buffer, &json->length, value);
+}
+
+
+static inline void json_put_number_double(JSON *json, const char *quoted_key, size_t key_len, double value)
+{
+    json_add_comma(json);
+    json_buffer_append(json->buffer, &json->length, quoted_key, key_len);
+    json_appendf(json, "%g", value);
+}
+
+
+static inline void json_put_null(JSON *json, const char *quoted_key, size_t key_len)
+{
+    json_add_comma(json);
+    json_buffer_append(json->buffer, &json->length, quoted_key, key_len);
+    json_buffer_append(json->buffer, &json->length, "null", 4);
 }
 
 
@@ -206,14 +473,14 @@ static inline void json_add_number_double(JSON *json, const char *key, double va
 static inline void json_array_add_string(JSONArray *arr, const char *value)
 {
     json_array_add_comma(arr);
-    json_array_appendf(arr, "\"%s\"", value);
+    json_buffer_append_escaped(arr->buffer, &arr->length, value);
 }
 
 
 static inline void json_array_add_number_int(JSONArray *arr, long long value)
 {
     json_array_add_comma(arr);
-    json_array_appendf(arr, "%lld", value);
+    json_buffer_append_int(arr->buffer, &arr->length, value);
 }
 
 
@@ -224,6 +491,124 @@ static inline void json_array_add_number_double(JSONArray *arr, double value)
 }
 
 
+/* =========================
+   ARRAY BULK ADD FUNCTIONS
+========================= */
+
+/*
+ * Bulk appends format straight into the array buffer. An element is
+ * only kept if it fits whole with room left for the closing ']', and
+ * each function returns how many of the n values were appended.
+ */
+
+#define JSON_INT_MAX_CHARS 21
+
+
+static inline size_t json_array_add_ints(JSONArray *arr, const long long *values, size_t n)
+{
+    char *buffer = arr->buffer;
+    size_t length = arr->length;
+    size_t i = 0;
+
+    /* room for ',' + longest int, with one byte kept for ']' and one for '\0' */
+    size_t safe_end = JSON_BUFFER_SIZE - 2 - (JSON_INT_MAX_CHARS + 1);
+
+    for (; i < n && length <= safe_end; i++)
+    {
+        if (arr->count + (int)i > 0)
+            buffer[length++] = ',';
+
+        length += json_format_int(buffer + length, values[i]);
+    }
+
+    for (; i < n; i++)
+    {
+        char tmp[JSON_INT_MAX_CHARS + 2];
+        size_t len = 0;
+
+        if (arr->count + (int)i > 0)
+            tmp[len++] = ',';
+
+        len += json_format_int(tmp + len, values[i]);
+
+        if (length + len > JSON_BUFFER_SIZE - 2)
+            break;
+
+        memcpy(buffer + length, tmp, len);
+        length += len;
+    }
+
+    buffer[length] = '\0';
+
+    arr->length = length;
+    arr->count += (int)i;
+
+    return i;
+}
+
+
+static inline size_t json_array_add_doubles(JSONArray *arr, const double *values, size_t n)
+{
+    char *buffer = arr->buffer;
+    size_t length = arr->length;
+    size_t i = 0;
+
+    for (; i < n; i++)
+    {
+        size_t start = length;
+
+        if (arr->count + (int)i > 0 && length < JSON_BUFFER_SIZE - 2)
+            buffer[length++] = ',';
+
+        /* leaves one byte for ']' after the '\0' snprintf writes */
+        size_t remaining = JSON_BUFFER_SIZE - 1 - length;
+        int written = snprintf(buffer + length, remaining, "%g", values[i]);
+
+        if (written < 0 || (size_t)written >= remaining)
+        {
+            length = start;
+            break;
+        }
+
+        length += (size_t)written;
+    }
+
+    buffer[length] = '\0';
+
+    arr->length = length;
+    arr->count += (int)i;
+
+    return i;
+}
+
+
+static inline size_t json_array_add_strings(JSONArray *arr, const char *const *values, size_t n)
+{
+    size_t i = 0;
+
+    for (; i < n; i++)
+    {
+        size_t start = arr->length;
+
+        if (arr->count + (int)i > 0)
+            json_buffer_append(arr->buffer, &arr->length, ",", 1);
+
+        json_buffer_append_escaped(arr->buffer, &arr->length, values[i]);
+
+        if (arr->length > JSON_BUFFER_SIZE - 2)
+        {
+            arr->length = start;
+            arr->buffer[start] = '\0';
+            break;
+        }
+    }
+
+    arr->count += (int)i;
+
+    return i;
+}
+
+
 static inline void json_array_close(JSONArray *arr)
 {
     if (!arr->closed && arr->length < JSON_BUFFER_SIZE - 1)
@@ -250,7 +635,8 @@ static inline void json_add_object(JSON *json, const char *key, JSON *child)
         child->closed = true;
     }
 
-    json_appendf(json, "\"%s\":%s", key, child->buffer);
+    json_append_key(json, key);
+    json_buffer_append(json->buffer, &json->length, child->buffer, child->length);
 }
 
 
@@ -260,7 +646,8 @@ static inline void json_add_array(JSON *json, const char *key, JSONArray *arr)
 
     json_array_close(arr);
 
-    json_appendf(json, "\"%s\":%s", key, arr->buffer);
+    json_append_key(json, key);
+    json_buffer_append(json->buffer, &json->length, arr->buffer, arr->length);
 }
 
 
@@ -302,6 +689,29 @@ static inline void json_add_array(JSON *json, const char *key, JSONArray *arr)
     )(arr, value)
 
 
+
+#define json_add_literal(json, key, value) \
+    _Generic((value), \
+        _Bool: json_put_bool, \
+        char*: json_put_string, \
+        const char*: json_put_string, \
+        int: json_put_number_int, \
+        long: json_put_number_int, \
+        long long: json_put_number_int, \
+        unsigned int: json_put_number_int, \
+        unsigned long: json_put_number_int, \
+        unsigned long long: json_put_number_int, \
+        float: json_put_number_double, \
+        double: json_put_number_double, \
+        long double: json_put_number_double \
+    )(json, JSON_QUOTED_KEY(key), sizeof(JSON_QUOTED_KEY(key)) - 1, value)
+
+
+
+#define json_add_null_literal(json, key) \
+    json_put_null(json, JSON_QUOTED_KEY(key), sizeof(JSON_QUOTED_KEY(key)) - 1)
+
+
 /* =========================
    STRINGIFY
 ========================= */
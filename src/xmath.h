@@ -1,19 +1,293 @@
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define XMATH_X86 1
+#include <immintrin.h>
+#endif
 
 int xsum(int a, int b)
 {
     return a + b;
 }
 
+/* a zero divisor gives -1; INT_MIN / -1 wraps to INT_MIN instead of trapping */
 int xdiv(int a, int b)
 {
     if (b == 0)
     {
         return -1;
     }
+    if (b == -1)
+    {
+        return (int)(0u - (unsigned)a);
+    }
     return a / b;
 }
 
 bool is_even(int number) {
     return number % 2 == 0;
-}
\ No newline at end of file
+}
+
+
+/* =========================
+   BATCH: DISPATCH
+========================= */
+
+typedef enum {
+    XMATH_SCALAR = 0,
+    XMATH_SSE2 = 1,
+    XMATH_AVX2 = 2
+} XMathLevel;
+
+static int xmath_level_cap = XMATH_AVX2;
+
+/* limits the kernels the batch functions may pick, e.g. to compare against scalar */
+void xmath_set_level(XMathLevel level)
+{
+    xmath_level_cap = level;
+}
+
+XMathLevel xmath_level(void)
+{
+    static int detected = -1;
+
+    if (detected < 0)
+    {
+        detected = XMATH_SCALAR;
+#ifdef XMATH_X86
+        detected = XMATH_SSE2;
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            detected = XMATH_AVX2;
+#endif
+    }
+
+    return (XMathLevel)(detected < xmath_level_cap ? detected : xmath_level_cap);
+}
+
+
+/* =========================
+   BATCH: SCALAR
+========================= */
+
+static void xsum_array_scalar(const int *a, const int *b, int *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = xsum(a[i], b[i]);
+}
+
+static void xdiv_array_scalar(const int *a, const int *b, int *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = xdiv(a[i], b[i]);
+}
+
+static void is_even_mask_scalar(const int *numbers, size_t n, uint8_t *mask)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (i % 8 == 0)
+            mask[i / 8] = 0;
+
+        if (is_even(numbers[i]))
+            mask[i / 8] |= (uint8_t)(1u << (i % 8));
+    }
+}
+
+
+/* =========================
+   BATCH: SSE2 / AVX2
+========================= */
+
+#ifdef XMATH_X86
+
+static void xsum_array_sse2(const int *a, const int *b, int *out, size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        _mm_storeu_si128((__m128i *)(out + i), _mm_add_epi32(va, vb));
+    }
+
+    xsum_array_scalar(a + i, b + i, out + i, n - i);
+}
+
+/*
+ * int32 division is exact through double: |quotient| <= 2^31 fits the
+ * 53-bit mantissa. The one out-of-range quotient, INT_MIN / -1 = 2^31,
+ * converts to 0x80000000 = INT_MIN, the value xdiv() defines for it.
+ */
+static void xdiv_array_sse2(const int *a, const int *b, int *out, size_t n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i minus_one = _mm_set1_epi32(-1);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+
+        __m128d lo = _mm_div_pd(_mm_cvtepi32_pd(va), _mm_cvtepi32_pd(vb));
+        __m128d hi = _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(va, 8)),
+                                _mm_cvtepi32_pd(_mm_srli_si128(vb, 8)));
+
+        __m128i q = _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+        __m128i by_zero = _mm_cmpeq_epi32(vb, zero);
+
+        q = _mm_or_si128(_mm_and_si128(by_zero, minus_one), _mm_andnot_si128(by_zero, q));
+
+        _mm_storeu_si128((__m128i *)(out + i), q);
+    }
+
+    xdiv_array_scalar(a + i, b + i, out + i, n - i);
+}
+
+static void is_even_mask_sse2(const int *numbers, size_t n, uint8_t *mask)
+{
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i lo = _mm_loadu_si128((const __m128i *)(numbers + i));
+        __m128i hi = _mm_loadu_si128((const __m128i *)(numbers + i + 4));
+
+        int bits_lo = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(lo, one), zero)));
+        int bits_hi = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(hi, one), zero)));
+
+        mask[i / 8] = (uint8_t)(bits_lo | (bits_hi << 4));
+    }
+
+    is_even_mask_scalar(numbers + i, n - i, mask + i / 8);
+}
+
+__attribute__((target("avx2")))
+static void xsum_array_avx2(const int *a, const int *b, int *out, size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_add_epi32(va, vb));
+    }
+
+    xsum_array_scalar(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void xdiv_array_avx2(const int *a, const int *b, int *out, size_t n)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i minus_one = _mm256_set1_epi32(-1);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+
+        __m256d lo = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(va)),
+                                   _mm256_cvtepi32_pd(_mm256_castsi256_si128(vb)));
+        __m256d hi = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(va, 1)),
+                                   _mm256_cvtepi32_pd(_mm256_extracti128_si256(vb, 1)));
+
+        __m256i q = _mm256_set_m128i(_mm256_cvttpd_epi32(hi), _mm256_cvttpd_epi32(lo));
+
+        q = _mm256_blendv_epi8(q, minus_one, _mm256_cmpeq_epi32(vb, zero));
+
+        _mm256_storeu_si256((__m256i *)(out + i), q);
+    }
+
+    xdiv_array_scalar(a + i, b + i, out + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void is_even_mask_avx2(const int *numbers, size_t n, uint8_t *mask)
+{
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(numbers + i));
+        __m256i even = _mm256_cmpeq_epi32(_mm256_and_si256(v, one), zero);
+
+        mask[i / 8] = (uint8_t)_mm256_movemask_ps(_mm256_castsi256_ps(even));
+    }
+
+    is_even_mask_scalar(numbers + i, n - i, mask + i / 8);
+}
+
+#endif
+
+
+/* =========================
+   BATCH: PUBLIC API
+========================= */
+
+/* out[i] = xsum(a[i], b[i]) */
+void xsum_array(const int *a, const int *b, int *out, size_t n)
+{
+#ifdef XMATH_X86
+    switch (xmath_level())
+    {
+    case XMATH_AVX2:
+        xsum_array_avx2(a, b, out, n);
+        return;
+    case XMATH_SSE2:
+        xsum_array_sse2(a, b, out, n);
+        return;
+    default:
+        break;
+    }
+#endif
+    xsum_array_scalar(a, b, out, n);
+}
+
+/* out[i] = xdiv(a[i], b[i]), so a zero divisor gives -1 and INT_MIN / -1 gives INT_MIN */
+void xdiv_array(const int *a, const int *b, int *out, size_t n)
+{
+#ifdef XMATH_X86
+    switch (xmath_level())
+    {
+    case XMATH_AVX2:
+        xdiv_array_avx2(a, b, out, n);
+        return;
+    case XMATH_SSE2:
+        xdiv_array_sse2(a, b, out, n);
+        return;
+    default:
+        break;
+    }
+#endif
+    xdiv_array_scalar(a, b, out, n);
+}
+
+/* bit i of mask (mask[i / 8], bit i % 8) is set when numbers[i] is even; mask holds (n + 7) / 8 bytes */
+void is_even_mask(const int *numbers, size_t n, uint8_t *mask)
+{
+#ifdef XMATH_X86
+    switch (xmath_level())
+    {
+    case XMATH_AVX2:
+        is_even_mask_avx2(numbers, n, mask);
+        return;
+    case XMATH_SSE2:
+        is_even_mask_sse2(numbers, n, mask);
+        return;
+    default:
+        break;
+    }
+#endif
+    is_even_mask_scalar(numbers, n, mask);
+}
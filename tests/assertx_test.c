@@ -84,10 +84,644 @@ void test_extract_test_functions()
     remove("temp_runner.c");
 }
 
+void test_extract_fuzz_functions()
+{
+    const char *fake_file = "temp_fuzz_file.c";
+
+    FILE *f = fopen(fake_file, "w");
+    fprintf(f,
+            "void test_one(){}\n"
+            "void fuzz_parser(const uint8_t *data, size_t len){}\n");
+    fclose(f);
+
+    FILE *runner = fopen("temp_runner.c", "w");
+
+    char functions[100][256];
+    int count = extract_fuzz_functions(fake_file, runner, functions);
+
+    fclose(runner);
+
+    assert_equal(count, 1,
+                 "Should extract 1 fuzz_ function");
+
+    assert_equal(strcmp(functions[0], "fuzz_parser"), 0,
+                 "Fuzz function should be fuzz_parser");
+
+    remove(fake_file);
+    remove("temp_runner.c");
+}
+
+void test_extract_fixtures()
+{
+    const char *fake_file = "temp_fixture_file.c";
+
+    FILE *f = fopen(fake_file, "w");
+    fprintf(f,
+            "static void setup_suite() {}\n"
+            "void teardown_each(void) {}\n"
+            "void setup_suite_helper() {}\n"
+            "void test_a() {}\n");
+    fclose(f);
+
+    int found[FIXTURE_COUNT];
+
+    assert_equal(extract_fixtures(fake_file, NULL, found), 2,
+                 "Only the four fixture names should be picked up");
+
+    assert_true(found[0] && found[3],
+                "setup_suite and teardown_each should be found");
+
+    assert_false(found[1] || found[2],
+                 "Missing fixtures should stay unset");
+
+    remove(fake_file);
+}
+
+void test_extract_timeouts()
+{
+    const char *fake_file = "temp_timeout_file.c";
+
+    FILE *f = fopen(fake_file, "w");
+    fprintf(f,
+            "// assertx: timeout=3\n"
+            "void test_slow(){}\n"
+            "void test_fast(){}\n");
+    fclose(f);
+
+    char functions[2][256] = {"test_slow", "test_fast"};
+    int timeouts[2];
+
+    extract_timeouts(fake_file, functions, 2, timeouts);
+
+    assert_equal(timeouts[0], 3,
+                 "Annotated function should get its own timeout");
+
+    assert_equal(timeouts[1], runner_options.timeout,
+                 "Other functions should get the default timeout");
+
+    int limited[2] = {3, 1};
+
+    assert_equal(file_time_limit(limited, 2, 1), 4 + TIMEOUT_GRACE_SECONDS,
+                 "File limit should add up function limits");
+
+    assert_equal(file_time_limit(timeouts, 2, 1), 0,
+                 "File limit should be off when a function is unlimited");
+
+    remove(fake_file);
+}
+
+/* =========================
+   baselines
+========================= */
+
+void test_mann_whitney_p()
+{
+    TimingResult slow = {.count = 5, .samples = {200, 210, 205, 220, 215}};
+    TimingResult fast = {.count = 5, .samples = {100, 110, 105, 120, 115}};
+
+    assert_true(mann_whitney_p(&slow, &fast) < 0.01,
+                "Clearly slower samples should be significant");
+
+    assert_true(mann_whitney_p(&fast, &fast) > 0.4,
+                "Identical samples should not be significant");
+}
+
+void test_timing_results_save_and_load()
+{
+    const char *path = "temp_baseline.txt";
+
+    TimingResults results = {0};
+    TimingResult *result = timing_results_put(&results, "bench", "math_test:bench_sum");
+
+    result->count = 3;
+    result->samples[0] = 10;
+    result->samples[1] = 30;
+    result->samples[2] = 20;
+
+    remove(path);
+    timing_results_save(&results, path);
+    timing_results_free(&results);
+
+    int loaded = timing_results_load(&results, path, NULL);
+    TimingResult *found = timing_results_find(&results, "math_test:bench_sum");
+
+    assert_equal(loaded, 1,
+                 "Should load 1 baseline entry");
+
+    assert_true(found != NULL && found->count == 3 && timing_median(found) == 20.0,
+                "Baseline entry should keep its samples");
+
+    timing_results_free(&results);
+    remove(path);
+}
+
+/* =========================
+   perf counters
+========================= */
+
+void test_perf_results_load()
+{
+    const char *path = "temp_counters.perf";
+
+    FILE *f = fopen(path, "w");
+    fprintf(f, "test_sum 1 1000 2500 -1 12 3\n");
+    fclose(f);
+
+    PerfResults results = {0};
+    int loaded = perf_results_load(&results, path, "math_test");
+
+    assert_equal(loaded, 1,
+                 "Should load 1 counter line");
+
+    assert_equal(strcmp(results.items[0].key, "math_test:test_sum"), 0,
+                 "Counter key should include the file");
+
+    assert_true(results.items[0].counts[1] == 2500 && results.items[0].counts[2] == -1,
+                "Counters should keep values and unavailable markers");
+
+    perf_results_free(&results);
+    remove(path);
+}
+
+/* =========================
+   capture ring
+========================= */
+
+void test_capture_ring_wraps()
+{
+    Capture capture;
+
+    if (!capture_open(&capture))
+    {
+        assert_false(capture_supported(), "capture_open should work where capture is supported");
+        return;
+    }
+
+    char line[1000];
+    memset(line, 'x', sizeof(line));
+
+    __capture = (__capture_header *)capture.header;
+
+    for (int i = 0; i < 3000; i++)
+        __capture_write(__CAPTURE_TEXT, line, sizeof(line));
+
+    __capture = NULL;
+
+    CaptureHeader *header = capture.header;
+    const char *data = (const char *)header + header->header_size;
+    uint64_t walked = 0;
+    int records = 0;
+
+    for (uint64_t offset = header->tail; offset < header->head; offset += walked)
+    {
+        walked = ((const CaptureRecord *)(data + offset % header->capacity))->size;
+
+        if (walked == 0)
+            break;
+
+        records++;
+    }
+
+    assert_true(header->overwritten > 0,
+                "Writing more than the ring holds should overwrite old records");
+
+    assert_true(header->head - header->tail <= header->capacity && walked != 0 && records > 1000,
+                "Records between tail and head should stay walkable after wrapping");
+
+    capture_close(&capture);
+}
+
+void test_capture_fd_close_on_exec()
+{
+#ifdef __linux__
+    Capture capture;
+
+    if (!capture_open(&capture))
+        return;
+
+    assert_true((fcntl(capture.fd, F_GETFD) & FD_CLOEXEC) != 0,
+                "The ring fd should not leak into compilers");
+
+    capture_inherit(capture.fd);
+
+    assert_true((fcntl(capture.fd, F_GETFD) & FD_CLOEXEC) == 0,
+                "The test process should keep the ring fd across exec");
+
+    capture_close(&capture);
+#endif
+}
+
+/* =========================
+   runtime selection
+========================= */
+
+void test_filter_matches_globs()
+{
+    assert_true(__test_matches("test_json_*", "test_json_reset"),
+                "* should match any suffix");
+
+    assert_true(__test_matches("test_?dd", "test_add"),
+                "? should match a single character");
+
+    assert_false(__test_matches("test_json_*", "test_xsum"),
+                 "Names outside the pattern should not match");
+
+    assert_true(__test_matches("test_xsum,test_json_*", "test_json_pool"),
+                "Any comma separated pattern may match");
+
+    assert_true(__test_matches(NULL, "test_anything"),
+                "No filter should match everything");
+}
+
+void test_binary_up_to_date()
+{
+    const char *binary = "temp_cache_binary";
+    const char *header = "temp_cache_header.h";
+    const char *deps = "temp_cache_binary.d";
+
+    FILE *f = fopen(header, "w");
+    fprintf(f, "#define X 1\n");
+    fclose(f);
+
+#ifndef _WIN32
+    usleep(20000);
+#endif
+
+    f = fopen(binary, "w");
+    fclose(f);
+
+    f = fopen(deps, "w");
+    fprintf(f, "temp_cache_binary.o: \\\n %s\n", header);
+    fclose(f);
+
+    assert_true(binary_up_to_date(binary, deps),
+                "Binary newer than its dependencies should be reused");
+
+#ifndef _WIN32
+    usleep(20000);
+#endif
+
+    f = fopen(header, "w");
+    fprintf(f, "#define X 2\n");
+    fclose(f);
+
+    assert_false(binary_up_to_date(binary, deps),
+                 "Touching a dependency should force a rebuild");
+
+    assert_false(binary_up_to_date(binary, "temp_missing.d"),
+                 "Missing dependency file should force a rebuild");
+
+    remove(binary);
+    remove(header);
+    remove(deps);
+}
+
+void test_shuffle_is_seeded_permutation()
+{
+    size_t first[16];
+    size_t second[16];
+    size_t seen = 0;
+
+    for (size_t i = 0; i < 16; i++)
+        first[i] = second[i] = i;
+
+    __test_shuffle(first, 16, 42);
+    __test_shuffle(second, 16, 42);
+
+    for (size_t i = 0; i < 16; i++)
+        seen |= (size_t)1 << first[i];
+
+    assert_equal((int)seen, 0xFFFF,
+                 "Shuffle should keep every test exactly once");
+
+    assert_true(memcmp(first, second, sizeof(first)) == 0,
+                "The same seed should give the same order");
+}
+
+/* =========================
+   trace
+========================= */
+
+void test_trace_write()
+{
+    const char *spans = "temp_trace_spans.txt";
+    const char *output = "temp_trace.json";
+
+    FILE *f = fopen(spans, "w");
+    fprintf(f, "2000 1000 test_one\n# dropped 0\n5000 3000 test_two\n");
+    fclose(f);
+
+    Trace trace = {0};
+
+    trace_start(&trace);
+    trace.origin_ns = 0;
+
+    trace_name_track(&trace, 1, "math_test.c");
+    trace_span(&trace, "runner", "compile", "math_test.c", TRACE_RUNNER_TRACK, 0, 1500);
+
+    assert_equal(trace_load(&trace, spans, 1), 2,
+                 "Span lines from the test binary should be loaded");
+
+    assert_true(trace_write(&trace, output),
+                "Trace should be written");
+
+    char text[2048] = {0};
+
+    f = fopen(output, "r");
+    fread(text, 1, sizeof(text) - 1, f);
+    fclose(f);
+
+    assert_true(strstr(text, "{\"name\":\"test_two\",\"cat\":\"test\",\"ph\":\"X\",\"ts\":5,\"dur\":3,") != NULL,
+                "Test spans should become complete events in microseconds");
+
+    assert_true(strstr(text, "\"args\":{\"name\":\"math_test.c\"}") != NULL,
+                "Tracks should be named after their test file");
+
+    trace_free(&trace);
+    remove(spans);
+    remove(output);
+}
+
+/* =========================
+   compiler backends
+========================= */
+
+void test_compiler_flags()
+{
+    char flags[256];
+    const CompilerBackend *tcc = compiler_find("tcc");
+    const CompilerBackend *gcc = compiler_find("gcc");
+
+    compiler_flags(flags, sizeof(flags), tcc, PROFILE_SANITIZE, 0);
+
+    assert_true(strstr(flags, "-b") != NULL,
+                "tcc should use its bounds checker for the sanitize profile");
+
+    compiler_flags(flags, sizeof(flags), gcc, PROFILE_RELEASE, 1);
+
+    assert_true(strstr(flags, "-O2") != NULL && strstr(flags, "trace-pc") != NULL,
+                "Fuzz flags should be added on top of the profile");
+
+    assert_null(compiler_find("msvc"),
+                "Unknown backends should not be found");
+
+    const CompilerBackend *picked = compiler_select("auto-fast", PROFILE_RELEASE, 0);
+
+    assert_true(picked == compiler_select("auto", PROFILE_RELEASE, 0),
+                "auto-fast should fall back to auto for release builds");
+
+    picked = compiler_select("auto-fast", PROFILE_DEBUG, 0);
+
+    assert_true(picked == (compiler_available(tcc) ? tcc : compiler_select("auto", PROFILE_DEBUG, 0)),
+                "auto-fast should take tcc for debug builds whenever it is installed");
+
+    picked = compiler_select("auto", PROFILE_DEBUG, 1);
+
+    assert_true(picked == NULL || picked->fuzz_flags != NULL,
+                "Fuzz builds should only pick backends with coverage support");
+
+    BuildProfile profile;
+
+    assert_true(profile_parse("sanitize", &profile) && profile == PROFILE_SANITIZE,
+                "sanitize should be a known profile");
+}
+
+/* =========================
+   CPU isolation
+========================= */
+
+void test_isolate_plan()
+{
+    CpuSet set;
+    char list[64];
+
+    assert_true(cpuset_parse("0-2,5", &set) && cpuset_count(&set) == 4 && cpuset_has(&set, 5),
+                "CPU lists should accept ranges and single CPUs");
+
+    cpuset_format(&set, list, sizeof(list));
+
+    assert_equal((const char *)list, "0-2,5",
+                 "Formatting should give the kernel list back");
+
+    assert_false(cpuset_parse("3-1", &set) || cpuset_parse("a", &set),
+                 "Malformed CPU lists should be rejected");
+
+    CpuSet allowed;
+    Isolation isolation;
+
+    cpuset_parse("0-3", &allowed);
+
+    assert_true(isolate_plan(&isolation, &allowed, NULL) &&
+                    cpuset_count(&isolation.tests) == 1 && cpuset_has(&isolation.tests, 3),
+                "Tests should get the last allowed CPU by default");
+
+    assert_true(cpuset_has(&isolation.compile, 0) && !cpuset_has(&isolation.compile, 3),
+                "Compiles should stay off the test CPU");
+
+    assert_false(isolate_plan(&isolation, &allowed, "8"),
+                 "A CPU outside the affinity mask cannot be reserved");
+
+    cpuset_parse("0", &allowed);
+
+    assert_true(isolate_plan(&isolation, &allowed, NULL) && cpuset_has(&isolation.compile, 0),
+                "With one CPU compiles and tests should share it");
+}
+
+/* =========================
+   shared objects
+========================= */
+
+void test_elf_test_symbols()
+{
+    const char *source = "temp_shared.c";
+    const char *library = "temp_shared.so";
+    char names[8][256];
+
+    FILE *f = fopen(source, "w");
+    fprintf(f, "void test_second(void) {}\n"
+               "static void test_private(void) {}\n"
+               "int helper(void) { test_private(); return 0; }\n"
+               "void test_third(void) {}\n");
+    fclose(f);
+
+    assert_equal(elf_test_symbols(source, names, 8), -1,
+                 "A file that is not ELF should be rejected");
+
+    if (!shared_supported() || system("gcc -shared -fPIC temp_shared.c -o temp_shared.so") != 0)
+    {
+        remove(source);
+        return;
+    }
+
+    int count = elf_test_symbols(library, names, 8);
+
+    assert_equal(count, 2,
+                 "Only exported test_ functions should be listed");
+
+    assert_true(count == 2 && strcmp(names[0], "test_second") == 0 &&
+                    strcmp(names[1], "test_third") == 0,
+                "Symbols should come back in source order");
+
+    assert_equal(elf_test_symbols(library, names, 1), 1,
+                 "The listing should stop at max");
+
+    remove(source);
+    remove(library);
+}
+
+void test_shared_keep_scraped()
+{
+    char names[3][256] = {"test_first", "test_helper_len", "test_last"};
+    char scraped[2][256] = {"test_last", "test_first"};
+
+    int count = shared_keep_scraped(names, 3, scraped, 2);
+
+    assert_equal(count, 2,
+                 "test_ helpers that are not void test_x() should be dropped");
+
+    assert_true(count == 2 && strcmp(names[0], "test_first") == 0 &&
+                    strcmp(names[1], "test_last") == 0,
+                "The kept symbols should stay in ELF order");
+}
+
 /* =========================
    run_test_file
 ========================= */
 
+void test_timeout_keeps_running_the_file()
+{
+    int total = 0;
+    int passed = 0;
+    int timeouts = runner_timeouts;
+
+    ensure_dir("temp_timeout_case");
+
+    FILE *f = fopen("temp_timeout_case/hang_test.c", "w");
+    fprintf(f, "#include \"../tests/xassert.h\"\n"
+               "// assertx: timeout=1\n"
+               "void test_hangs() { for (;;) {} }\n"
+               "void test_after() { fclose(fopen(\"temp_after_ran\", \"w\")); }\n");
+    fclose(f);
+
+    remove("temp_after_ran");
+    run_test_file("temp_timeout_case", "hang_test.c", &total, &passed);
+
+    FILE *marker = fopen("temp_after_ran", "r");
+
+    assert_true(marker != NULL,
+                "Functions after a timed out one should still run");
+    assert_equal(runner_timeouts, timeouts + 1,
+                 "The file should still be reported as timed out");
+
+    if (marker)
+        fclose(marker);
+
+    remove("temp_after_ran");
+    remove("temp_timeout_case/hang_test.c");
+    rmdir("temp_timeout_case");
+    runner_timeouts = timeouts;
+}
+
+void test_empty_selection_skips_suite_fixtures()
+{
+    int total = 0;
+    int passed = 0;
+    const char *filter = runner_options.filter;
+
+    ensure_dir("temp_fixture_case");
+
+    FILE *f = fopen("temp_fixture_case/suite_test.c", "w");
+    fprintf(f, "#include \"../tests/xassert.h\"\n"
+               "void setup_suite() { fclose(fopen(\"temp_suite_ran\", \"w\")); }\n"
+               "void test_something() {}\n");
+    fclose(f);
+
+    remove("temp_suite_ran");
+    runner_options.filter = "test_nothing_matches";
+    run_test_file("temp_fixture_case", "suite_test.c", &total, &passed);
+    runner_options.filter = filter;
+
+    FILE *marker = fopen("temp_suite_ran", "r");
+
+    assert_true(marker == NULL,
+                "setup_suite should not run when no test is selected");
+
+    if (marker)
+        fclose(marker);
+
+    remove("temp_suite_ran");
+    remove("temp_fixture_case/suite_test.c");
+    rmdir("temp_fixture_case");
+}
+
+void test_timing_samples_do_not_count_failures()
+{
+    int total = 0;
+    int passed = 0;
+    int samples = runner_options.samples;
+
+    ensure_dir("temp_samples_case");
+
+    /* passes the first time only, like a test with side effects */
+    FILE *f = fopen("temp_samples_case/once_test.c", "w");
+    fprintf(f, "#include \"../tests/xassert.h\"\n"
+               "static int calls = 0;\n"
+               "void test_once() { assert_equal(++calls, 1, \"first call\"); }\n");
+    fclose(f);
+
+    runner_options.samples = 5;
+    run_test_file("temp_samples_case", "once_test.c", &total, &passed);
+    runner_options.samples = samples;
+
+    assert_true(total == 1 && passed == 1,
+                "Failures in the timing re-runs should not fail the test");
+
+    remove("temp_samples_case/once_test.c");
+    rmdir("temp_samples_case");
+}
+
+void test_tcc_builds_and_runs_a_file()
+{
+    const CompilerBackend *tcc = compiler_find("tcc");
+
+    if (!compiler_available(tcc))
+        return;
+
+    int total = 0;
+    int passed = 0;
+    const CompilerBackend *backend = runner_backend;
+    BuildProfile profile = runner_profile;
+    int repeat = runner_options.repeat;
+
+    ensure_dir("temp_tcc_case");
+
+    FILE *f = fopen("temp_tcc_case/tcc_test.c", "w");
+    fprintf(f, "#include \"../tests/xassert.h\"\n"
+               "void test_equal() { assert_equal(2 + 2, 4, \"sum\"); }\n"
+               "void test_memory() { char a[40] = {1}, b[40] = {1}; assert_mem_equal(a, b, sizeof(a), \"bytes\"); }\n");
+    fclose(f);
+
+    runner_backend = tcc;
+    runner_profile = PROFILE_DEBUG;
+    run_test_file("temp_tcc_case", "tcc_test.c", &total, &passed);
+
+    assert_true(total == 1 && passed == 1,
+                "A test file should build and pass under tcc");
+
+    /* --repeat goes through the shared counters that tcc cannot build with __atomic_* */
+    runner_options.repeat = 2;
+    run_test_file("temp_tcc_case", "tcc_test.c", &total, &passed);
+
+    assert_true(total == 2 && passed == 2,
+                "--repeat should build and pass under tcc");
+
+    runner_backend = backend;
+    runner_profile = profile;
+    runner_options.repeat = repeat;
+    remove("temp_tcc_case/tcc_test.c");
+    rmdir("temp_tcc_case");
+}
+
 void test_run_test_file_invalid()
 {
     int total = 0;
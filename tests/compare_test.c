@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "xassert.h"
+
+/*
+ * Kernels are checked at every level the CPU has, against offsets on
+ * and around the vector and unroll boundaries.
+ */
+
+#define BIG_BYTES (8 * 1024 * 1024)
+#define BIG_DOUBLES (1024 * 1024)
+
+static uint8_t *big_actual = NULL;
+static uint8_t *big_expected = NULL;
+static double *big_values = NULL;
+static double *big_nearby = NULL;
+
+void setup_suite()
+{
+    big_actual = suite_alloc(BIG_BYTES);
+    big_expected = suite_alloc(BIG_BYTES);
+    big_values = suite_alloc(sizeof(double) * BIG_DOUBLES);
+    big_nearby = suite_alloc(sizeof(double) * BIG_DOUBLES);
+
+    for (size_t i = 0; i < BIG_BYTES; i++)
+        big_actual[i] = big_expected[i] = (uint8_t)(i * 31 + 7);
+
+    for (size_t i = 0; i < BIG_DOUBLES; i++)
+    {
+        big_values[i] = (double)i * 0.25 - 1000.0;
+        big_nearby[i] = big_values[i] + 1e-12;
+    }
+}
+
+void test_mem_diff_finds_first_offset()
+{
+    static const size_t offsets[] = {0, 1, 15, 16, 63, 64, 127, 128, 200, 4095, 4097, 9999};
+    uint8_t a[10000];
+    uint8_t b[10000];
+    bool ok = true;
+
+    for (int level = __TEST_SCALAR; level <= __TEST_AVX2; level++)
+    {
+        __test_simd_cap = level;
+
+        for (size_t k = 0; k < sizeof(offsets) / sizeof(offsets[0]); k++)
+        {
+            for (size_t i = 0; i < sizeof(a); i++)
+                a[i] = b[i] = (uint8_t)i;
+
+            b[offsets[k]] ^= 0x40;
+
+            if (offsets[k] + 3 < sizeof(b))
+                b[offsets[k] + 3] ^= 0x01;
+
+            ok = ok && __test_mem_diff(a, b, sizeof(a)) == offsets[k];
+        }
+
+        ok = ok && __test_mem_diff(a, a, sizeof(a)) == sizeof(a);
+    }
+
+    __test_simd_cap = __TEST_AVX2;
+
+    assert_true(ok, "mem diff should report the first differing byte at every level");
+}
+
+void test_near_diff_handles_special_values()
+{
+    double a[37];
+    double b[37];
+    bool ok = true;
+
+    for (int level = __TEST_SCALAR; level <= __TEST_AVX2; level++)
+    {
+        __test_simd_cap = level;
+
+        for (int i = 0; i < 37; i++)
+            a[i] = b[i] = i * 1.5;
+
+        a[3] = b[3] = 1.0 / 0.0;
+        a[5] = 0.0 / 0.0;
+        b[5] = a[5];
+        b[20] += 1e-10;
+
+        ok = ok && __test_near_diff(a, b, 37, 1e-9) == 37;
+
+        b[33] += 1e-3;
+        ok = ok && __test_near_diff(a, b, 37, 1e-9) == 33;
+
+        b[1] = 0.0 / 0.0;
+        ok = ok && __test_near_diff(a, b, 37, 1e-9) == 1;
+    }
+
+    __test_simd_cap = __TEST_AVX2;
+
+    assert_true(ok, "Infinities and NaN pairs should match, a single NaN should not");
+}
+
+void test_ulps_diff_counts_representable_steps()
+{
+    double a[23];
+    double b[23];
+    bool ok = true;
+
+    assert_equal((int)__test_ulps_between(0.0, -0.0), 0, "Both zeros should be 0 ulps apart");
+    assert_true(__test_ulps_between(1.0, -1.0) > 1000, "Opposite signs should be far apart");
+
+    for (int level = __TEST_SCALAR; level <= __TEST_AVX2; level++)
+    {
+        __test_simd_cap = level;
+
+        for (int i = 0; i < 23; i++)
+        {
+            a[i] = (i - 11) * 0.1;
+            b[i] = a[i];
+        }
+
+        int64_t bits;
+        memcpy(&bits, &b[7], sizeof(bits));
+        bits += 2;
+        memcpy(&b[7], &bits, sizeof(bits));
+
+        ok = ok && __test_ulps_diff(a, b, 23, 2) == 23;
+        ok = ok && __test_ulps_diff(a, b, 23, 1) == 7;
+
+        b[21] = -b[21];
+        ok = ok && __test_ulps_diff(a, b, 23, 2) == 21;
+    }
+
+    __test_simd_cap = __TEST_AVX2;
+
+    assert_true(ok, "ulps diff should report the first element past the limit");
+}
+
+void test_ulps_diff_rejects_nan_next_to_infinity()
+{
+    double a[9];
+    double b[9];
+    bool ok = true;
+    uint64_t nan_bits = 0x7FF0000000000001ULL;
+    uint64_t negative_nan_bits = 0xFFF0000000000001ULL;
+
+    for (int level = __TEST_SCALAR; level <= __TEST_AVX2; level++)
+    {
+        __test_simd_cap = level;
+
+        for (int i = 0; i < 9; i++)
+            a[i] = b[i] = i * 0.5;
+
+        /* NaN one step above +inf in bits, inside any large ulps limit */
+        memcpy(&a[2], &nan_bits, sizeof(double));
+        b[2] = 1.0 / 0.0;
+
+        ok = ok && __test_ulps_diff(a, b, 9, 1ULL << 40) == 2;
+
+        b[2] = a[2];
+        ok = ok && __test_ulps_diff(a, b, 9, 1ULL << 40) == 9;
+
+        memcpy(&b[6], &negative_nan_bits, sizeof(double));
+        a[6] = -1.0 / 0.0;
+
+        ok = ok && __test_ulps_diff(a, b, 9, 1ULL << 40) == 6;
+    }
+
+    __test_simd_cap = __TEST_AVX2;
+
+    assert_true(ok, "A NaN against an infinity should fail at every level, however large ulps is");
+}
+
+void test_assertions_on_big_buffers()
+{
+    assert_mem_equal(big_actual, big_expected, BIG_BYTES, "8 MB buffers should be equal");
+    assert_array_near(big_nearby, big_values, BIG_DOUBLES, 1e-9, "Values should be within eps");
+    assert_array_ulps(big_values, big_values, BIG_DOUBLES, 0, "Identical arrays should be 0 ulps apart");
+}
+
+void bench_mem_equal_8m()
+{
+    bench_items(BIG_BYTES);
+    assert_mem_equal(big_actual, big_expected, BIG_BYTES, "8 MB buffers should be equal");
+}
+
+void bench_memcmp_8m()
+{
+    bench_items(BIG_BYTES);
+    assert_true(memcmp(big_actual, big_expected, BIG_BYTES) == 0, "8 MB buffers should be equal");
+}
+
+void bench_array_near_1m()
+{
+    bench_items(BIG_DOUBLES);
+    assert_array_near(big_nearby, big_values, BIG_DOUBLES, 1e-9, "Values should be within eps");
+}
+
+void bench_array_ulps_1m()
+{
+    bench_items(BIG_DOUBLES);
+    assert_array_ulps(big_values, big_values, BIG_DOUBLES, 4, "Values should be within 4 ulps");
+}
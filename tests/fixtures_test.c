@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "xassert.h"
+#include "../src/xmath.h"
+
+/*
+ * setup_suite builds the dataset once for the whole file; setup_each
+ * and teardown_each run around every test function.
+ */
+
+#define DATASET_SIZE 4096
+
+static int *dataset = NULL;
+static int scratch[16];
+static int each_active = 0;
+
+void setup_suite()
+{
+    dataset = suite_alloc(sizeof(int) * DATASET_SIZE);
+
+    assert_true(dataset != NULL, "suite dataset should be allocated");
+
+    for (int i = 0; i < DATASET_SIZE; i++)
+        dataset[i] = i;
+}
+
+void teardown_suite()
+{
+    dataset = NULL;
+}
+
+void setup_each()
+{
+    memset(scratch, 0, sizeof(scratch));
+    each_active = 1;
+}
+
+void teardown_each()
+{
+    each_active = 0;
+}
+
+void test_dataset_is_shared()
+{
+    assert_true(dataset != NULL && dataset[DATASET_SIZE - 1] == DATASET_SIZE - 1,
+                "Tests should see the dataset built by setup_suite");
+}
+
+void test_setup_each_runs_first()
+{
+    assert_equal(each_active, 1, "setup_each should run before the test");
+    assert_equal(scratch[0], 0, "setup_each should reset the scratch buffer");
+
+    scratch[0] = 42;
+}
+
+void test_scratch_is_reset()
+{
+    assert_equal(scratch[0], 0, "Changes to scratch should not leak between tests");
+
+    int sums[4];
+    xsum_array(dataset, dataset, sums, 4);
+
+    assert_equal(sums[3], 6, "The dataset should be usable as read-only input");
+}
@@ -212,3 +212,422 @@ void test_json_nested_object()
         "json_add_object should support nested object"
     );
 }
+
+
+/* ===============================
+   TEST LITERAL KEYS
+   =============================== */
+
+void test_json_add_literal()
+{
+    JSON json = json_new();
+
+    json_add_literal(&json, "name", "Gabriel");
+    json_add_literal(&json, "age", 20);
+    json_add_literal(&json, "height", 1.75);
+    json_add_literal(&json, "admin", (bool)true);
+    json_add_null_literal(&json, "data");
+
+    assert_equal(
+        json_stringify(&json),
+        "{\"name\":\"Gabriel\",\"age\":20,\"height\":1.75,\"admin\":true,\"data\":null}",
+        "json_add_literal should match json_add output"
+    );
+}
+
+
+/* ===============================
+   TEST ESCAPING
+   =============================== */
+
+void test_json_escape()
+{
+    JSON json = json_new();
+
+    json_add_string(&json, "say \"hi\"", "line\n\ttab\\ \x01");
+
+    assert_equal(
+        json_stringify(&json),
+        "{\"say \\\"hi\\\"\":\"line\\n\\ttab\\\\ \\u0001\"}",
+        "runtime keys and string values should be escaped"
+    );
+}
+
+
+/* ===============================
+   TEST NEGATIVE INT
+   =============================== */
+
+void test_json_add_negative_int()
+{
+    JSON json = json_new();
+
+    json_add(&json, "min", -9223372036854775807LL - 1);
+    json_add(&json, "zero", 0);
+
+    assert_equal(
+        json_stringify(&json),
+        "{\"min\":-9223372036854775808,\"zero\":0}",
+        "json_add should format negative and zero ints"
+    );
+}
+
+
+/* ===============================
+   TEST RESET
+   =============================== */
+
+void test_json_reset()
+{
+    JSON json = json_new();
+
+    json_add(&json, "name", "Gabriel");
+    json_stringify(&json);
+
+    json_reset(&json);
+    json_add(&json, "age", 20);
+
+    assert_equal(
+        json_stringify(&json),
+        "{\"age\":20}",
+        "json_reset should start a new object in the same builder"
+    );
+}
+
+
+/* ===============================
+   TEST POOL
+   =============================== */
+
+void test_json_pool()
+{
+    JSON *first = json_acquire();
+
+    json_add(first, "name", "Gabriel");
+    json_release(first);
+
+    JSON *second = json_acquire();
+
+    assert_true(second == first,
+                "json_acquire should reuse the last released builder");
+
+    assert_equal(second->buffer, "{",
+                 "json_acquire should return a reset builder");
+
+    json_release(second);
+    json_pool_clear();
+}
+
+
+/* ===============================
+   TEST ARRAY BULK ADD
+   =============================== */
+
+void test_json_array_add_ints()
+{
+    JSONArray arr = json_array_new();
+    long long values[] = {1, -20, 300};
+
+    json_array_add(&arr, 0);
+    size_t added = json_array_add_ints(&arr, values, 3);
+    json_array_close(&arr);
+
+    assert_true(added == 3, "json_array_add_ints should add every value");
+
+    assert_equal(arr.buffer, "[0,1,-20,300]",
+                 "json_array_add_ints should continue an existing array");
+}
+
+void test_json_array_add_doubles()
+{
+    JSONArray arr = json_array_new();
+    double values[] = {1.5, -0.25, 1e20};
+
+    json_array_add_doubles(&arr, values, 3);
+    json_array_close(&arr);
+
+    assert_equal(arr.buffer, "[1.5,-0.25,1e+20]",
+                 "json_array_add_doubles should format like json_array_add");
+}
+
+void test_json_array_add_strings()
+{
+    JSONArray arr = json_array_new();
+    const char *values[] = {"admin", "a \"quoted\" user"};
+
+    json_array_add_strings(&arr, values, 2);
+    json_array_close(&arr);
+
+    assert_equal(arr.buffer, "[\"admin\",\"a \\\"quoted\\\" user\"]",
+                 "json_array_add_strings should escape values");
+}
+
+void test_json_array_add_ints_full()
+{
+    JSONArray arr = json_array_new();
+    static long long values[4096];
+
+    for (int i = 0; i < 4096; i++)
+        values[i] = 1000000 + i;
+
+    size_t added = json_array_add_ints(&arr, values, 4096);
+    json_array_close(&arr);
+
+    assert_true(added > 0 && added < 4096,
+                "json_array_add_ints should stop when the buffer is full");
+
+    assert_true(arr.closed && arr.buffer[arr.length - 1] == ']' && arr.buffer[arr.length - 2] != ',',
+                "a full array should still close after its last whole value");
+}
+
+
+/* ===============================
+   FUZZ ADD STRING
+   =============================== */
+
+void fuzz_json_add_string(const uint8_t *data, size_t len)
+{
+    char value[JSON_BUFFER_SIZE];
+    size_t n = len < sizeof(value) - 1 ? len : sizeof(value) - 1;
+
+    memcpy(value, data, n);
+    value[n] = '\0';
+
+    JSON json = json_new();
+
+    json_add_string(&json, "key", value);
+
+    char *out = json_stringify(&json);
+
+    assert_true(strlen(out) == json.length,
+                "json length should match buffer contents");
+
+    assert_true(json.length < JSON_BUFFER_SIZE,
+                "json length should stay inside the buffer");
+}
+
+
+/* ===============================
+   FUZZ ESCAPING
+   =============================== */
+
+static size_t json_unescape(const char *in, size_t len, char *out)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if (in[i] != '\\')
+        {
+            out[n++] = in[i];
+            continue;
+        }
+
+        char c = in[++i];
+
+        if (c == 'n') out[n++] = '\n';
+        else if (c == 'r') out[n++] = '\r';
+        else if (c == 't') out[n++] = '\t';
+        else if (c == 'b') out[n++] = '\b';
+        else if (c == 'f') out[n++] = '\f';
+        else if (c == 'u')
+        {
+            out[n++] = (char)strtol((char[]){in[i + 3], in[i + 4], 0}, NULL, 16);
+            i += 4;
+        }
+        else out[n++] = c;
+    }
+
+    return n;
+}
+
+void fuzz_json_escape(const uint8_t *data, size_t len)
+{
+    char value[1024];
+    size_t n = len < sizeof(value) - 1 ? len : sizeof(value) - 1;
+
+    memcpy(value, data, n);
+    value[n] = '\0';
+
+    JSON json = json_new();
+
+    json_add_string(&json, "k", value);
+
+    char *out = json_stringify(&json);
+    size_t prefix = strlen("{\"k\":\"");
+
+    bool raw_control = false;
+    for (size_t i = 0; i < json.length; i++)
+        raw_control = raw_control || (unsigned char)out[i] < 0x20;
+
+    assert_false(raw_control, "escaped output should not contain control characters");
+
+    char decoded[1024];
+    size_t decoded_len = json_unescape(out + prefix, json.length - prefix - 2, decoded);
+
+    assert_true(decoded_len == strlen(value) && memcmp(decoded, value, decoded_len) == 0,
+                "escaped string should decode back to the input");
+}
+
+
+/* ===============================
+   BENCH 10-FIELD RECORDS
+   =============================== */
+
+#define BENCH_RECORDS 100000
+
+void bench_json_record_runtime_keys()
+{
+    volatile size_t sink = 0;
+
+    for (int i = 0; i < BENCH_RECORDS; i++)
+    {
+        JSON json = json_new();
+
+        json_add(&json, "id", i);
+        json_add(&json, "name", "Gabriel");
+        json_add(&json, "city", "Recife");
+        json_add(&json, "age", 20);
+        json_add(&json, "height", 1.75);
+        json_add(&json, "admin", (bool)true);
+        json_add(&json, "score", i * 3);
+        json_add(&json, "status", "active");
+        json_add(&json, "visits", 12345);
+        json_add_null(&json, "data");
+
+        sink += strlen(json_stringify(&json));
+    }
+
+    bench_items(BENCH_RECORDS);
+}
+
+static size_t bench_record(JSON *json, int i)
+{
+    json_add_literal(json, "id", i);
+    json_add_literal(json, "name", "Gabriel");
+    json_add_literal(json, "city", "Recife");
+    json_add_literal(json, "age", 20);
+    json_add_literal(json, "height", 1.75);
+    json_add_literal(json, "admin", (bool)true);
+    json_add_literal(json, "score", i * 3);
+    json_add_literal(json, "status", "active");
+    json_add_literal(json, "visits", 12345);
+    json_add_null_literal(json, "data");
+
+    return strlen(json_stringify(json));
+}
+
+void bench_json_record_literal_keys()
+{
+    volatile size_t sink = 0;
+
+    for (int i = 0; i < BENCH_RECORDS; i++)
+    {
+        JSON json = json_new();
+        sink += bench_record(&json, i);
+    }
+
+    bench_items(BENCH_RECORDS);
+}
+
+
+/* ===============================
+   BENCH BUILDER REUSE
+   =============================== */
+
+void bench_json_record_heap_new()
+{
+    volatile size_t sink = 0;
+
+    for (int i = 0; i < BENCH_RECORDS; i++)
+    {
+        JSON *json = malloc(sizeof(JSON));
+        *json = json_new();
+        sink += bench_record(json, i);
+        free(json);
+    }
+
+    bench_items(BENCH_RECORDS);
+}
+
+void bench_json_record_reset()
+{
+    volatile size_t sink = 0;
+    static JSON json;
+
+    for (int i = 0; i < BENCH_RECORDS; i++)
+    {
+        json_reset(&json);
+        sink += bench_record(&json, i);
+    }
+
+    bench_items(BENCH_RECORDS);
+}
+
+void bench_json_record_pool()
+{
+    volatile size_t sink = 0;
+
+    for (int i = 0; i < BENCH_RECORDS; i++)
+    {
+        JSON *json = json_acquire();
+        sink += bench_record(json, i);
+        json_release(json);
+    }
+
+    bench_items(BENCH_RECORDS);
+}
+
+
+/* ===============================
+   BENCH ARRAY BULK ADD
+   =============================== */
+
+#define BENCH_ARRAY_VALUES 1000000
+#define BENCH_ARRAY_CHUNK 512
+
+static long long bench_ints[BENCH_ARRAY_CHUNK];
+
+static void bench_fill_ints()
+{
+    for (int i = 0; i < BENCH_ARRAY_CHUNK; i++)
+        bench_ints[i] = (long long)i * 7919 - 100000;
+}
+
+void bench_json_array_ints_single()
+{
+    static JSONArray arr;
+    volatile size_t sink = 0;
+
+    bench_fill_ints();
+
+    for (int done = 0; done < BENCH_ARRAY_VALUES; done += BENCH_ARRAY_CHUNK)
+    {
+        json_array_reset(&arr);
+
+        for (int i = 0; i < BENCH_ARRAY_CHUNK; i++)
+            json_array_add_number_int(&arr, bench_ints[i]);
+
+        sink += arr.length;
+    }
+
+    bench_items(BENCH_ARRAY_VALUES);
+}
+
+void bench_json_array_ints_bulk()
+{
+    static JSONArray arr;
+    volatile size_t sink = 0;
+
+    bench_fill_ints();
+
+    for (int done = 0; done < BENCH_ARRAY_VALUES; done += BENCH_ARRAY_CHUNK)
+    {
+        json_array_reset(&arr);
+        json_array_add_ints(&arr, bench_ints, BENCH_ARRAY_CHUNK);
+
+        sink += arr.length;
+    }
+
+    bench_items(BENCH_ARRAY_VALUES);
+}
@@ -1,4 +1,27 @@
-#ifndef TEST_FRAMEWORK_H
+/*
+ * Formatação de durações. Fica fora do resto do framework para o runner
+ * incluir só ela (XASSERT_FORMAT_ONLY) e os dois imprimirem tempos iguais.
+ */
+#ifndef TEST_FORMAT_NS_H
+#define TEST_FORMAT_NS_H
+
+#include <stdio.h>
+
+static void __test_format_ns(char *out, size_t size, double ns)
+{
+    if (ns < 1e3)
+        snprintf(out, size, "%.0f ns", ns);
+    else if (ns < 1e6)
+        snprintf(out, size, "%.2f µs", ns / 1e3);
+    else if (ns < 1e9)
+        snprintf(out, size, "%.2f ms", ns / 1e6);
+    else
+        snprintf(out, size, "%.2f s", ns / 1e9);
+}
+
+#endif
+
+#if !defined(TEST_FRAMEWORK_H) && !defined(XASSERT_FORMAT_ONLY)
 #define TEST_FRAMEWORK_H
 
 #include <stdio.h>
@@ -6,21 +29,258 @@
 #include <string.h>
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#endif
+
+/* kernels com vector_size do GCC/clang: nada de <immintrin.h> em todo arquivo de teste */
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(__TINYC__) && \
+    (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define __TEST_X86 1
+#endif
+
 #define string const char *
 
+/* funções da API com prefixo test_ ficam fora da tabela dinâmica: assertx --shared as tomaria por testes */
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_WIN32)
+#define __TEST_API __attribute__((visibility("hidden")))
+#else
+#define __TEST_API
+#endif
+
+/*
+ * Memória compartilhada com o runner e entre os filhos de --repeat. O tcc
+ * não tem os __atomic_*: sem otimizador ele não reordena acessos, loads e
+ * stores simples do x86 já têm ordem de acquire/release, e a soma usa lock xadd.
+ */
+#if defined(__TINYC__)
+#define __test_atomic_store(p, v) (*(volatile __typeof__(*(p)) *)(p) = (v))
+#define __test_atomic_load(p) (*(volatile __typeof__(*(p)) *)(p))
+
+static int __test_atomic_add(int *p, int value)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __asm__ __volatile__("lock; xaddl %0, %1" : "=r"(value), "+m"(*p) : "0"(value) : "memory");
+    return value;
+#else
+    int old = *(volatile int *)p;
+    *(volatile int *)p = old + value;
+    return old;
+#endif
+}
+#else
+#define __test_atomic_store(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#define __test_atomic_load(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define __test_atomic_add(p, v) __atomic_fetch_add(p, v, __ATOMIC_RELAXED)
+#endif
+
 static int __test_failures = 0;
 static int __test_assertions = 0;
+static bool __test_quiet = false;
+static string __test_last_failure = NULL;
+
+/* repetições de __test_run só para medir tempo: uma falha nelas não conta */
+static bool __test_sampling = false;
+static string __test_sample_failure = NULL;
+
+/* ===============================
+   Captura em memória compartilhada (assertx --capture)
+   =============================== */
+
+/*
+ * Mesmo layout de src/assertx_capture.h. O runner cria um memfd e
+ * passa o fd em ASSERTX_CAPTURE_FD; aqui o stdout vira uma stream que
+ * grava registros TEXT no anel e as asserções viram eventos próprios.
+ */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t header_size;
+    uint64_t capacity;
+    uint64_t head;
+    uint64_t tail;
+    uint64_t overwritten;
+} __capture_header;
+
+typedef struct {
+    uint32_t size;
+    uint32_t type;
+    uint64_t length;
+} __capture_record;
+
+enum {
+    __CAPTURE_PAD = 0,
+    __CAPTURE_TEXT = 1,
+    __CAPTURE_TEST_START = 2,
+    __CAPTURE_TEST_END = 3,
+    __CAPTURE_ASSERT_PASS = 4,
+    __CAPTURE_ASSERT_FAIL = 5
+};
+
+static __capture_header *__capture = NULL;
+
+static void __capture_make_room(uint64_t head, uint64_t size)
+{
+    char *data = (char *)__capture + __capture->header_size;
+
+    while (head + size - __capture->tail > __capture->capacity)
+    {
+        __capture_record *oldest = (__capture_record *)(data + __capture->tail % __capture->capacity);
+        __capture->tail += oldest->size;
+        __capture->overwritten++;
+    }
+}
+
+static void __capture_write(uint32_t type, const void *payload, size_t length)
+{
+    if (!__capture)
+        return;
+
+    uint64_t capacity = __capture->capacity;
+    uint64_t limit = capacity / 4;
+
+    if (length + sizeof(__capture_record) > limit)
+        length = (size_t)(limit - sizeof(__capture_record));
+
+    uint64_t size = (sizeof(__capture_record) + length + 7) & ~(uint64_t)7;
+    uint64_t head = __capture->head;
+    uint64_t pos = head % capacity;
+    char *data = (char *)__capture + __capture->header_size;
+
+    if (pos + size > capacity)
+    {
+        uint64_t pad = capacity - pos;
+        __capture_make_room(head, pad);
+
+        __capture_record *filler = (__capture_record *)(data + pos);
+        filler->size = (uint32_t)pad;
+        filler->type = __CAPTURE_PAD;
+        filler->length = 0;
+
+        head += pad;
+        pos = 0;
+    }
+
+    __capture_make_room(head, size);
+
+    __capture_record *record = (__capture_record *)(data + pos);
+    record->size = (uint32_t)size;
+    record->type = type;
+    record->length = length;
+    memcpy(record + 1, payload, length);
+
+    __test_atomic_store(&__capture->head, head + size);
+}
+
+static void __capture_event(uint32_t type, string text)
+{
+    __capture_write(type, text, strlen(text));
+}
+
+#if defined(__linux__) && defined(_GNU_SOURCE)
+static ssize_t __capture_stream_write(void *cookie, const char *buffer, size_t size)
+{
+    (void)cookie;
+    __capture_write(__CAPTURE_TEXT, buffer, size);
+    return (ssize_t)size;
+}
+#endif
+
+static void __capture_setup(void)
+{
+#ifdef __linux__
+    string fd_text = getenv("ASSERTX_CAPTURE_FD");
+
+    if (!fd_text)
+        return;
+
+    int fd = atoi(fd_text);
+    struct stat st;
+
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(__capture_header))
+        return;
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (map == MAP_FAILED)
+        return;
+
+    if (((__capture_header *)map)->magic != 0x42525841u)
+    {
+        munmap(map, (size_t)st.st_size);
+        return;
+    }
+
+    __capture = map;
+
+#ifdef _GNU_SOURCE
+    cookie_io_functions_t io = {NULL, __capture_stream_write, NULL, NULL};
+    FILE *stream = fopencookie(NULL, "w", io);
+
+    if (stream)
+    {
+        fflush(stdout);
+        setvbuf(stream, NULL, _IONBF, 0); /* nada fica preso no buffer se o teste cair */
+        stdout = stream;
+    }
+#endif
+#endif
+}
+
+/* escreve direto no fd 1 ou no anel; seguro dentro de handlers de sinal */
+static void __test_emergency_print(string text)
+{
+    if (__capture)
+    {
+        __capture_event(__CAPTURE_TEXT, text);
+        return;
+    }
+
+#ifndef _WIN32
+    ssize_t ignored = write(STDOUT_FILENO, text, strlen(text));
+    (void)ignored;
+#else
+    fputs(text, stdout);
+#endif
+}
 
 void assertx(bool condition, string message)
 {
     __test_assertions++;
 
     if (condition)
-        printf("   ✅ %s\n", message);
+    {
+        if (!__test_quiet)
+        {
+            printf("   ✅ %s\n", message);
+            __capture_event(__CAPTURE_ASSERT_PASS, message);
+        }
+    }
+    else if (__test_sampling)
+        __test_sample_failure = message;
     else
     {
         printf("   ❌ %s\n", message);
         __test_failures++;
+        __test_last_failure = message;
+
+        __capture_event(__CAPTURE_ASSERT_FAIL, message);
     }
 }
 
@@ -66,14 +326,2117 @@ void assert_true(bool condition, string message) { assertx(condition, message);
 
 void assert_false(bool condition, string message) { assertx(!condition, message); }
 
-void test_summary()
+/* imprime o resumo e devolve o código de saída, sem sair */
+static int __test_report(void)
 {
     printf("\n----------------------------------\n");
     printf("Assertions: %d\n", __test_assertions);
     printf("Failures  : %d\n", __test_failures);
     printf("----------------------------------\n");
 
-    exit(__test_failures > 0);
+    return __test_failures > 0;
+}
+
+__TEST_API void test_summary()
+{
+    exit(__test_report());
+}
+
+/* ===============================
+   Comparação de buffers e arrays (SIMD)
+   =============================== */
+
+/*
+ * assert_mem_equal, assert_array_near e assert_array_ulps comparam
+ * blocos inteiros com SSE2/AVX2 e só descem para o escalar no bloco
+ * onde algo difere, para achar o primeiro índice. Na falha mostram o
+ * contexto em volta da primeira diferença.
+ */
+
+enum { __TEST_SCALAR = 0, __TEST_SSE2 = 1, __TEST_AVX2 = 2 };
+
+/* limita os kernels usados, para comparar os níveis entre si */
+static int __test_simd_cap = __TEST_AVX2;
+
+static int __test_simd_level(void)
+{
+    static int detected = -1;
+
+    if (detected < 0)
+    {
+        detected = __TEST_SCALAR;
+#ifdef __TEST_X86
+        detected = __TEST_SSE2;
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            detected = __TEST_AVX2;
+#endif
+    }
+
+    return detected < __test_simd_cap ? detected : __test_simd_cap;
+}
+
+/* NaN só é igual a NaN: saídas de referência costumam guardar NaN de propósito */
+static inline bool __test_double_near(double a, double b, double eps)
+{
+    if (a != a || b != b)
+        return a != a && b != b;
+
+    if (a == b)
+        return true;
+
+    double diff = a > b ? a - b : b - a;
+
+    return diff <= eps;
+}
+
+/* posição de x na reta dos doubles, em que vizinhos diferem de 1 */
+static inline int64_t __test_ordered(double x)
+{
+    int64_t bits;
+
+    memcpy(&bits, &x, sizeof(bits));
+
+    return bits < 0 ? INT64_MIN - bits : bits;
+}
+
+static inline uint64_t __test_ulps_between(double a, double b)
+{
+    if (a != a || b != b)
+        return (a != a && b != b) ? 0 : UINT64_MAX;
+
+    int64_t x = __test_ordered(a);
+    int64_t y = __test_ordered(b);
+
+    return x > y ? (uint64_t)x - (uint64_t)y : (uint64_t)y - (uint64_t)x;
+}
+
+static size_t __test_mem_diff_scalar(const uint8_t *a, const uint8_t *b, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (a[i] != b[i])
+            return i;
+    }
+
+    return n;
+}
+
+static size_t __test_near_diff_scalar(const double *a, const double *b, size_t n, double eps)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (!__test_double_near(a[i], b[i], eps))
+            return i;
+    }
+
+    return n;
+}
+
+static size_t __test_ulps_diff_scalar(const double *a, const double *b, size_t n, uint64_t ulps)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (__test_ulps_between(a[i], b[i]) > ulps)
+            return i;
+    }
+
+    return n;
+}
+
+#ifdef __TEST_X86
+
+typedef uint8_t __test_u8x16 __attribute__((vector_size(16)));
+typedef uint8_t __test_u8x32 __attribute__((vector_size(32)));
+typedef int64_t __test_i64x2 __attribute__((vector_size(16)));
+typedef int64_t __test_i64x4 __attribute__((vector_size(32)));
+typedef uint64_t __test_u64x4 __attribute__((vector_size(32)));
+typedef double __test_f64x2 __attribute__((vector_size(16)));
+typedef double __test_f64x4 __attribute__((vector_size(32)));
+
+/* as versões _u leem de qualquer endereço, como __m256i_u do <immintrin.h> */
+typedef uint8_t __test_u8x16_u __attribute__((vector_size(16), aligned(1), __may_alias__));
+typedef uint8_t __test_u8x32_u __attribute__((vector_size(32), aligned(1), __may_alias__));
+typedef int64_t __test_i64x4_u __attribute__((vector_size(32), aligned(1), __may_alias__));
+typedef double __test_f64x2_u __attribute__((vector_size(16), aligned(1), __may_alias__));
+typedef double __test_f64x4_u __attribute__((vector_size(32), aligned(1), __may_alias__));
+
+#define __TEST_LOAD(type, p) (*(const type##_u *)(p))
+
+static size_t __test_mem_diff_sse2(const uint8_t *a, const uint8_t *b, size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 64 <= n; i += 64)
+    {
+        __test_u8x16 e0 = (__test_u8x16)(__TEST_LOAD(__test_u8x16, a + i) == __TEST_LOAD(__test_u8x16, b + i));
+        __test_u8x16 e1 = (__test_u8x16)(__TEST_LOAD(__test_u8x16, a + i + 16) == __TEST_LOAD(__test_u8x16, b + i + 16));
+        __test_u8x16 e2 = (__test_u8x16)(__TEST_LOAD(__test_u8x16, a + i + 32) == __TEST_LOAD(__test_u8x16, b + i + 32));
+        __test_u8x16 e3 = (__test_u8x16)(__TEST_LOAD(__test_u8x16, a + i + 48) == __TEST_LOAD(__test_u8x16, b + i + 48));
+
+        __test_i64x2 lanes = (__test_i64x2)((e0 & e1) & (e2 & e3));
+
+        if ((lanes[0] & lanes[1]) != -1)
+            return i + __test_mem_diff_scalar(a + i, b + i, 64);
+    }
+
+    return i + __test_mem_diff_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static size_t __test_mem_diff_avx2(const uint8_t *a, const uint8_t *b, size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 128 <= n; i += 128)
+    {
+        __test_u8x32 e0 = (__test_u8x32)(__TEST_LOAD(__test_u8x32, a + i) == __TEST_LOAD(__test_u8x32, b + i));
+        __test_u8x32 e1 = (__test_u8x32)(__TEST_LOAD(__test_u8x32, a + i + 32) == __TEST_LOAD(__test_u8x32, b + i + 32));
+        __test_u8x32 e2 = (__test_u8x32)(__TEST_LOAD(__test_u8x32, a + i + 64) == __TEST_LOAD(__test_u8x32, b + i + 64));
+        __test_u8x32 e3 = (__test_u8x32)(__TEST_LOAD(__test_u8x32, a + i + 96) == __TEST_LOAD(__test_u8x32, b + i + 96));
+
+        __test_i64x4 lanes = (__test_i64x4)((e0 & e1) & (e2 & e3));
+
+        if ((lanes[0] & lanes[1] & lanes[2] & lanes[3]) != -1)
+            return i + __test_mem_diff_scalar(a + i, b + i, 128);
+    }
+
+    return i + __test_mem_diff_scalar(a + i, b + i, n - i);
+}
+
+static size_t __test_near_diff_sse2(const double *a, const double *b, size_t n, double eps)
+{
+    const __test_f64x2 limit = {eps, eps};
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __test_i64x2 ok = {-1, -1};
+
+        for (size_t k = 0; k < 8; k += 2)
+        {
+            __test_f64x2 diff = __TEST_LOAD(__test_f64x2, a + i + k) - __TEST_LOAD(__test_f64x2, b + i + k);
+            __test_f64x2 distance = (__test_f64x2)((__test_i64x2)diff & INT64_MAX);
+
+            ok &= distance <= limit;
+        }
+
+        /* NaN e infinito caem aqui e o escalar decide */
+        if ((ok[0] & ok[1]) != -1)
+        {
+            size_t j = __test_near_diff_scalar(a + i, b + i, 8, eps);
+
+            if (j < 8)
+                return i + j;
+        }
+    }
+
+    return i + __test_near_diff_scalar(a + i, b + i, n - i, eps);
+}
+
+__attribute__((target("avx2")))
+static size_t __test_near_diff_avx2(const double *a, const double *b, size_t n, double eps)
+{
+    const __test_f64x4 limit = {eps, eps, eps, eps};
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __test_i64x4 ok = {-1, -1, -1, -1};
+
+        for (size_t k = 0; k < 16; k += 4)
+        {
+            __test_f64x4 diff = __TEST_LOAD(__test_f64x4, a + i + k) - __TEST_LOAD(__test_f64x4, b + i + k);
+            __test_f64x4 distance = (__test_f64x4)((__test_i64x4)diff & INT64_MAX);
+
+            ok &= distance <= limit;
+        }
+
+        if ((ok[0] & ok[1] & ok[2] & ok[3]) != -1)
+        {
+            size_t j = __test_near_diff_scalar(a + i, b + i, 16, eps);
+
+            if (j < 16)
+                return i + j;
+        }
+    }
+
+    return i + __test_near_diff_scalar(a + i, b + i, n - i, eps);
+}
+
+/* SSE2 não compara inteiros de 64 bits, então ULPs só tem kernel AVX2 */
+__attribute__((target("avx2")))
+static size_t __test_ulps_diff_avx2(const double *a, const double *b, size_t n, uint64_t ulps)
+{
+    const int64_t limit = ulps > (uint64_t)INT64_MAX ? INT64_MAX : (int64_t)ulps;
+    const int64_t exponent = 0x7FF0000000000000LL;
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __test_i64x4 x = __TEST_LOAD(__test_i64x4, a + i);
+        __test_i64x4 y = __TEST_LOAD(__test_i64x4, b + i);
+
+        /* expoente todo em 1 (inf ou NaN): a distância em bits não vale, o escalar decide */
+        __test_i64x4 special = ((x & exponent) == exponent) | ((y & exponent) == exponent);
+
+        __test_i64x4 x_negative = x < 0;
+        __test_i64x4 y_negative = y < 0;
+
+        /* aritmética sem sinal: o estouro dá a volta como no kernel escalar */
+        __test_u64x4 ux = (__test_u64x4)x;
+        __test_u64x4 uy = (__test_u64x4)y;
+        __test_u64x4 min = (__test_u64x4)(__test_i64x4){INT64_MIN, INT64_MIN, INT64_MIN, INT64_MIN};
+
+        ux = ((min - ux) & (__test_u64x4)x_negative) | (ux & ~(__test_u64x4)x_negative);
+        uy = ((min - uy) & (__test_u64x4)y_negative) | (uy & ~(__test_u64x4)y_negative);
+
+        __test_i64x4 d = (__test_i64x4)(ux - uy);
+        __test_i64x4 d_negative = d < 0;
+
+        d = (__test_i64x4)((((__test_u64x4){0} - (__test_u64x4)d) & (__test_u64x4)d_negative) |
+                           ((__test_u64x4)d & ~(__test_u64x4)d_negative));
+
+        /* sinais diferentes podem estourar a subtração: o escalar confere */
+        __test_i64x4 bad = (d > limit) | (x_negative ^ y_negative) | special;
+
+        if ((bad[0] | bad[1] | bad[2] | bad[3]) != 0)
+        {
+            size_t j = __test_ulps_diff_scalar(a + i, b + i, 4, ulps);
+
+            if (j < 4)
+                return i + j;
+        }
+    }
+
+    return i + __test_ulps_diff_scalar(a + i, b + i, n - i, ulps);
+}
+
+#undef __TEST_LOAD
+
+#endif
+
+/* offset do primeiro byte diferente, ou n quando os buffers são iguais */
+static size_t __test_mem_diff(const void *a, const void *b, size_t n)
+{
+#ifdef __TEST_X86
+    switch (__test_simd_level())
+    {
+    case __TEST_AVX2:
+        return __test_mem_diff_avx2(a, b, n);
+    case __TEST_SSE2:
+        return __test_mem_diff_sse2(a, b, n);
+    default:
+        break;
+    }
+#endif
+    return __test_mem_diff_scalar(a, b, n);
+}
+
+static size_t __test_near_diff(const double *a, const double *b, size_t n, double eps)
+{
+#ifdef __TEST_X86
+    switch (__test_simd_level())
+    {
+    case __TEST_AVX2:
+        return __test_near_diff_avx2(a, b, n, eps);
+    case __TEST_SSE2:
+        return __test_near_diff_sse2(a, b, n, eps);
+    default:
+        break;
+    }
+#endif
+    return __test_near_diff_scalar(a, b, n, eps);
+}
+
+static size_t __test_ulps_diff(const double *a, const double *b, size_t n, uint64_t ulps)
+{
+#ifdef __TEST_X86
+    if (__test_simd_level() == __TEST_AVX2)
+        return __test_ulps_diff_avx2(a, b, n, ulps);
+#endif
+    return __test_ulps_diff_scalar(a, b, n, ulps);
+}
+
+static void __test_hex_row(string label, const uint8_t *p, size_t row, size_t n)
+{
+    printf("      %-8s %08zx: ", label, row);
+
+    for (size_t k = 0; k < 16; k++)
+    {
+        if (row + k < n)
+            printf("%02x ", p[row + k]);
+        else
+            printf("   ");
+    }
+
+    printf(" |");
+
+    for (size_t k = 0; k < 16 && row + k < n; k++)
+        putchar(p[row + k] >= 32 && p[row + k] < 127 ? p[row + k] : '.');
+
+    printf("|\n");
+}
+
+static void __test_mem_context(const uint8_t *actual, const uint8_t *expected, size_t n, size_t offset)
+{
+    size_t row = offset & ~(size_t)15;
+    size_t first = row >= 16 ? row - 16 : row;
+    size_t last = row + 16 < n ? row + 16 : row;
+
+    printf("      first difference at offset %zu (0x%zx) of %zu bytes\n", offset, offset, n);
+
+    for (size_t r = first; r <= last; r += 16)
+    {
+        __test_hex_row("actual", actual, r, n);
+        __test_hex_row("expected", expected, r, n);
+
+        if (r != row)
+            continue;
+
+        printf("      %-8s %8s  ", "", "");
+
+        for (size_t k = 0; k < 16 && r + k < n; k++)
+            printf("%s", actual[r + k] != expected[r + k] ? "^^ " : "   ");
+
+        printf("\n");
+    }
+}
+
+static void __test_array_context(const double *actual, const double *expected, size_t n, size_t index)
+{
+    size_t first = index >= 3 ? index - 3 : 0;
+    size_t last = index + 3 < n ? index + 3 : n - 1;
+
+    for (size_t i = first; i <= last; i++)
+        printf("      %s [%zu] actual %.17g  expected %.17g\n",
+               i == index ? ">" : " ", i, actual[i], expected[i]);
+}
+
+void assert_mem_equal(const void *actual, const void *expected, size_t n, string message)
+{
+    size_t offset = __test_mem_diff(actual, expected, n);
+
+    assertx(offset == n, message);
+
+    if (offset < n)
+        __test_mem_context(actual, expected, n, offset);
+}
+
+/* |actual[i] - expected[i]| <= eps para todo i */
+void assert_array_near(const double *actual, const double *expected, size_t n, double eps, string message)
+{
+    size_t index = __test_near_diff(actual, expected, n, eps);
+
+    assertx(index == n, message);
+
+    if (index < n)
+    {
+        double diff = actual[index] - expected[index];
+
+        printf("      first difference at index %zu of %zu: |diff| %.3g > eps %.3g\n",
+               index, n, diff < 0 ? -diff : diff, eps);
+        __test_array_context(actual, expected, n, index);
+    }
 }
 
+/* no máximo ulps doubles representáveis entre actual[i] e expected[i] */
+void assert_array_ulps(const double *actual, const double *expected, size_t n, long long ulps, string message)
+{
+    uint64_t limit = ulps < 0 ? 0 : (uint64_t)ulps;
+    size_t index = __test_ulps_diff(actual, expected, n, limit);
+
+    assertx(index == n, message);
+
+    if (index < n)
+    {
+        uint64_t distance = __test_ulps_between(actual[index], expected[index]);
+
+        if (distance == UINT64_MAX)
+            printf("      first difference at index %zu of %zu: NaN against a number\n", index, n);
+        else
+            printf("      first difference at index %zu of %zu: %llu ulps > %lld\n",
+                   index, n, (unsigned long long)distance, ulps);
+
+        __test_array_context(actual, expected, n, index);
+    }
+}
+
+/* ===============================
+   Tempo
+   =============================== */
+
+static inline long long __test_now_ns(void)
+{
+    struct timespec ts;
+#ifdef _WIN32
+    timespec_get(&ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* ===============================
+   Trace (assertx --trace)
+   =============================== */
+
+/*
+ * Cada chamada de função vira um span guardado em memória; o arquivo
+ * em ASSERTX_TRACE só é escrito na saída do processo, então medir não
+ * custa I/O. O runner converte as linhas "<início> <duração> <nome>"
+ * para o formato Chrome Trace.
+ */
+
+#define __TRACE_MAX_EVENTS 4096
+
+typedef struct {
+    string name;
+    long long start;
+    long long duration;
+} __trace_event;
+
+static __trace_event __trace_events[__TRACE_MAX_EVENTS];
+static int __trace_count = 0;
+static int __trace_dropped = 0;
+static string __trace_path = NULL;
+
+static void __trace_span(string name, long long start, long long duration)
+{
+    if (!__trace_path)
+        return;
+
+    if (__trace_count == __TRACE_MAX_EVENTS)
+    {
+        __trace_dropped++;
+        return;
+    }
+
+    __trace_events[__trace_count++] = (__trace_event){name, start, duration};
+}
+
+static void __trace_flush(void)
+{
+    if (!__trace_path || __trace_count == 0)
+        return;
+
+    FILE *f = fopen(__trace_path, "w");
+
+    if (!f)
+        return;
+
+    for (int i = 0; i < __trace_count; i++)
+        fprintf(f, "%lld %lld %s\n", __trace_events[i].start,
+                __trace_events[i].duration, __trace_events[i].name);
+
+    if (__trace_dropped > 0)
+        fprintf(f, "# dropped %d\n", __trace_dropped);
+
+    fclose(f);
+    __trace_count = 0;
+}
+
+static void __trace_setup(void)
+{
+    __trace_path = getenv("ASSERTX_TRACE");
+
+    if (__trace_path)
+        atexit(__trace_flush);
+}
+
+/* ===============================
+   Contadores de hardware (assertx --perf-counters)
+   =============================== */
+
+#define __PERF_COUNTERS 5
+
+static string __perf_names[__PERF_COUNTERS] = {
+    "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses"};
+
+static string __perf_path = NULL;
+static int __perf_fds[__PERF_COUNTERS] = {-1, -1, -1, -1, -1};
+static long long __perf_totals[__PERF_COUNTERS];
+static long long __perf_calls = 0;
+static bool __perf_ready = false;
+
+#ifdef __linux__
+static int __perf_open(uint32_t type, uint64_t config)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+static void __perf_setup(void)
+{
+    __perf_path = getenv("ASSERTX_PERF");
+
+    if (!__perf_path)
+        return;
+
+#ifdef __linux__
+    __perf_fds[0] = __perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    __perf_fds[1] = __perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    __perf_fds[2] = __perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    __perf_fds[3] = __perf_open(PERF_TYPE_HW_CACHE,
+                                PERF_COUNT_HW_CACHE_L1D |
+                                    (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    __perf_fds[4] = __perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+
+    for (int i = 0; i < __PERF_COUNTERS; i++)
+        if (__perf_fds[i] >= 0)
+            __perf_ready = true;
+
+    if (!__perf_ready)
+    {
+        int paranoid = -1;
+        FILE *f = fopen("/proc/sys/kernel/perf_event_paranoid", "r");
+
+        if (f)
+        {
+            if (fscanf(f, "%d", &paranoid) != 1)
+                paranoid = -1;
+            fclose(f);
+        }
+
+        printf("   ⚠️ perf counters unavailable (perf_event_paranoid=%d)\n", paranoid);
+    }
+#else
+    printf("   ⚠️ perf counters are only available on Linux\n");
+#endif
+}
+
+static void __perf_reset(void)
+{
+    memset(__perf_totals, 0, sizeof(__perf_totals));
+    __perf_calls = 0;
+}
+
+static void __perf_start(void)
+{
+#ifdef __linux__
+    if (!__perf_ready)
+        return;
+
+    for (int i = 0; i < __PERF_COUNTERS; i++)
+    {
+        if (__perf_fds[i] < 0)
+            continue;
+        ioctl(__perf_fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(__perf_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+static void __perf_stop(void)
+{
+#ifdef __linux__
+    if (!__perf_ready)
+        return;
+
+    for (int i = 0; i < __PERF_COUNTERS; i++)
+    {
+        if (__perf_fds[i] >= 0)
+            ioctl(__perf_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    for (int i = 0; i < __PERF_COUNTERS; i++)
+    {
+        uint64_t values[3];
+
+        if (__perf_fds[i] < 0 || read(__perf_fds[i], values, sizeof(values)) != sizeof(values))
+            continue;
+
+        /* escala quando o kernel multiplexou o contador */
+        if (values[2] > 0 && values[2] < values[1])
+            values[0] = (uint64_t)((double)values[0] * (double)values[1] / (double)values[2]);
+
+        __perf_totals[i] += (long long)values[0];
+    }
+
+    __perf_calls++;
+#endif
+}
+
+static void __perf_report(string name)
+{
+    if (!__perf_ready || __perf_calls == 0)
+        return;
+
+    long long avg[__PERF_COUNTERS];
+
+    for (int i = 0; i < __PERF_COUNTERS; i++)
+        avg[i] = __perf_fds[i] >= 0 ? __perf_totals[i] / __perf_calls : -1;
+
+    printf("   📈");
+
+    for (int i = 0; i < __PERF_COUNTERS; i++)
+        if (avg[i] >= 0)
+            printf(" %s=%lld", __perf_names[i], avg[i]);
+
+    if (avg[0] > 0 && avg[1] >= 0)
+        printf(" IPC=%.2f", (double)avg[1] / (double)avg[0]);
+
+    printf("\n");
+
+    FILE *f = fopen(__perf_path, "a");
+
+    if (!f)
+        return;
+
+    fprintf(f, "%s %lld", name, __perf_calls);
+
+    for (int i = 0; i < __PERF_COUNTERS; i++)
+        fprintf(f, " %lld", avg[i]);
+
+    fprintf(f, "\n");
+    fclose(f);
+}
+
+/* ===============================
+   Fixtures (setup_suite / setup_each)
+   =============================== */
+
+/*
+ * O runner encontra funções void setup_suite, teardown_suite,
+ * setup_each e teardown_each no arquivo de teste. setup_suite roda uma
+ * vez antes de tudo (e antes dos fork de --repeat, então os filhos
+ * herdam o estado por copy-on-write); setup_each/teardown_each envolvem
+ * cada chamada fora da medição de tempo.
+ */
+
+typedef struct {
+    void (*setup_suite)(void);
+    void (*teardown_suite)(void);
+    void (*setup_each)(void);
+    void (*teardown_each)(void);
+} __test_fixtures;
+
+static const __test_fixtures *__test_suite = NULL;
+
+#define __SUITE_MAX_REGIONS 64
+
+typedef struct {
+    void *data;
+    size_t size;
+} __suite_region;
+
+static __suite_region __suite_regions[__SUITE_MAX_REGIONS];
+static int __suite_region_count = 0;
+
+/*
+ * Memória para o estado do setup_suite. Depois que setup_suite
+ * retorna ela vira somente leitura, então um teste que altera o estado
+ * compartilhado cai na hora em vez de contaminar os seguintes.
+ */
+void *suite_alloc(size_t size)
+{
+    if (size == 0 || __suite_region_count == __SUITE_MAX_REGIONS)
+        return NULL;
+
+#ifndef _WIN32
+    long page = sysconf(_SC_PAGESIZE);
+    size_t rounded = (size + (size_t)page - 1) & ~((size_t)page - 1);
+    void *data = mmap(NULL, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (data == MAP_FAILED)
+        return NULL;
+#else
+    size_t rounded = size;
+    void *data = calloc(1, size);
+
+    if (!data)
+        return NULL;
+#endif
+
+    __suite_regions[__suite_region_count++] = (__suite_region){data, rounded};
+
+    return data;
+}
+
+static void __suite_protect(bool writable)
+{
+#ifndef _WIN32
+    for (int i = 0; i < __suite_region_count; i++)
+        mprotect(__suite_regions[i].data, __suite_regions[i].size,
+                 writable ? PROT_READ | PROT_WRITE : PROT_READ);
+#else
+    (void)writable;
+#endif
+}
+
+static void __suite_release(void)
+{
+    for (int i = 0; i < __suite_region_count; i++)
+    {
+#ifndef _WIN32
+        munmap(__suite_regions[i].data, __suite_regions[i].size);
+#else
+        free(__suite_regions[i].data);
+#endif
+    }
+
+    __suite_region_count = 0;
+}
+
+/* roda setup_suite; false quando ele falhou e os testes não devem rodar */
+static bool __test_suite_begin(const __test_fixtures *fixtures)
+{
+    __test_suite = fixtures;
+
+    if (!fixtures || !fixtures->setup_suite)
+        return true;
+
+    int failures = __test_failures;
+
+    printf("→ setup_suite\n");
+    fixtures->setup_suite();
+
+    if (__test_failures != failures)
+    {
+        printf("   ❌ setup_suite failed, skipping the tests\n");
+        return false;
+    }
+
+    __suite_protect(false);
+
+    return true;
+}
+
+static void __test_suite_end(void)
+{
+    if (__test_suite && __test_suite->teardown_suite)
+    {
+        __suite_protect(true);
+
+        printf("→ teardown_suite\n");
+        __test_suite->teardown_suite();
+    }
+
+    __suite_release();
+    __test_suite = NULL;
+}
+
+/* ===============================
+   Execução e medição
+   =============================== */
+
+#define __TEST_MAX_SAMPLES 64
+
+static int __test_samples = 1;
+static string __test_results_path = NULL;
+static long long __bench_items_count = 0;
+
+/* limite em segundos da próxima função (0 = usa o padrão de --timeout) */
+static int __test_function_timeout = 0;
+static int __test_default_timeout = 0;
+static char __test_timeout_message[320];
+
+#ifndef _WIN32
+/* onde o runner quer saber de qual teste recomeçar depois de um estouro */
+static string __test_resume_path = NULL;
+static char __test_resume_text[64];
+#endif
+
+static void __test_configure(void)
+{
+    static bool configured = false;
+
+    if (configured)
+        return;
+
+    configured = true;
+
+    string samples = getenv("ASSERTX_SAMPLES");
+
+    if (samples)
+    {
+        __test_samples = atoi(samples);
+
+        if (__test_samples < 1)
+            __test_samples = 1;
+        if (__test_samples > __TEST_MAX_SAMPLES)
+            __test_samples = __TEST_MAX_SAMPLES;
+    }
+
+    __test_results_path = getenv("ASSERTX_RESULTS");
+
+    string timeout = getenv("ASSERTX_TIMEOUT");
+
+    if (timeout)
+        __test_default_timeout = atoi(timeout);
+
+#ifndef _WIN32
+    __test_resume_path = getenv("ASSERTX_RESUME");
+#endif
+
+    __capture_setup();
+    __perf_setup();
+    __trace_setup();
+}
+
+/* quantidade de itens processados por chamada de um bench_ */
+void bench_items(long long count) { __bench_items_count = count; }
+
+static int __test_cmp_ll(const void *a, const void *b)
+{
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+static void __test_record(string kind, string name, const long long *samples, int count)
+{
+    if (!__test_results_path)
+        return;
+
+    FILE *f = fopen(__test_results_path, "a");
+
+    if (!f)
+        return;
+
+    fprintf(f, "%s %s %d", kind, name, count);
+
+    for (int i = 0; i < count; i++)
+        fprintf(f, " %lld", samples[i]);
+
+    fprintf(f, "\n");
+    fclose(f);
+}
+
+#ifndef _WIN32
+/*
+ * Não dá para voltar com segurança para dentro do processo: o teste pode
+ * ter parado segurando o lock do malloc ou do stdio. Só chamadas seguras
+ * em handler aqui; o runner lê a posição e reinicia o arquivo nela.
+ */
+static void __test_on_timeout(int sig)
+{
+    (void)sig;
+
+    __test_emergency_print(__test_timeout_message);
+
+    if (__test_resume_path && __test_resume_text[0])
+    {
+        int fd = open(__test_resume_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (fd >= 0)
+        {
+            ssize_t ignored = write(fd, __test_resume_text, strlen(__test_resume_text));
+            (void)ignored;
+            close(fd);
+        }
+    }
+
+    _exit(124);
+}
+#endif
+
+/* posição do próximo teste, e a semente se a ordem foi embaralhada */
+static void __test_set_resume(size_t next, bool shuffle, unsigned long long seed)
+{
+#ifndef _WIN32
+    if (shuffle)
+        snprintf(__test_resume_text, sizeof(__test_resume_text), "%zu %llu\n", next, seed);
+    else
+        snprintf(__test_resume_text, sizeof(__test_resume_text), "%zu\n", next);
+#else
+    (void)next;
+    (void)shuffle;
+    (void)seed;
+#endif
+}
+
+/* executa fn uma vez, respeitando o limite de tempo, e retorna a duração em ns */
+static long long __test_call(string name, void (*fn)(void))
+{
+    int timeout = __test_function_timeout > 0 ? __test_function_timeout : __test_default_timeout;
+
+#ifndef _WIN32
+    if (timeout > 0)
+    {
+        snprintf(__test_timeout_message, sizeof(__test_timeout_message),
+                 "   ⏱️ %s timed out after %ds\n", name, timeout);
+        signal(SIGALRM, __test_on_timeout);
+        alarm((unsigned)timeout);
+    }
+#else
+    (void)name;
+#endif
+
+    if (__test_suite && __test_suite->setup_each)
+        __test_suite->setup_each();
+
+    __perf_start();
+    long long start = __test_now_ns();
+    fn();
+    long long elapsed = __test_now_ns() - start;
+    __perf_stop();
+
+    __trace_span(name, start, elapsed);
+
+    if (__test_suite && __test_suite->teardown_each)
+        __test_suite->teardown_each();
+
+#ifndef _WIN32
+    if (timeout > 0)
+        alarm(0);
+#endif
+
+    return elapsed;
+}
+
+void __test_run(string name, void (*fn)(void))
+{
+    long long samples[__TEST_MAX_SAMPLES];
+
+    __test_configure();
+
+    printf("→ %s\n", name);
+    fflush(stdout);
+
+    __capture_event(__CAPTURE_TEST_START, name);
+
+    __perf_reset();
+    samples[0] = __test_call(name, fn);
+
+    /*
+     * Amostras extras só para medir tempo: não contam asserções nem falhas.
+     * Se uma repetição falha o teste não se repete igual (efeitos colaterais,
+     * flaky), então a amostragem para ali e fica só com as amostras boas.
+     */
+    int count = 1;
+
+    if (__test_samples > 1)
+    {
+        int assertions = __test_assertions;
+
+        __test_quiet = true;
+        __test_sampling = true;
+        __test_sample_failure = NULL;
+
+        while (count < __test_samples)
+        {
+            long long elapsed = __test_call(name, fn);
+
+            if (__test_sample_failure)
+                break;
+
+            samples[count++] = elapsed;
+        }
+
+        __test_sampling = false;
+        __test_quiet = false;
+        __test_assertions = assertions;
+
+        if (__test_sample_failure)
+            printf("   ⚠️ Stopped timing after %d of %d samples, a repeated run failed: %s\n",
+                   count, __test_samples, __test_sample_failure);
+    }
+
+    __test_record("test", name, samples, count);
+    __perf_report(name);
+
+    __capture_event(__CAPTURE_TEST_END, name);
+}
+
+void __test_run_with_timeout(string name, void (*fn)(void), int seconds)
+{
+    __test_function_timeout = seconds;
+    __test_run(name, fn);
+    __test_function_timeout = 0;
+}
+
+void __test_bench(string name, void (*fn)(void))
+{
+    long long samples[__TEST_MAX_SAMPLES];
+    long long sorted[__TEST_MAX_SAMPLES];
+
+    __test_configure();
+
+    printf("→ %s\n", name);
+
+    __capture_event(__CAPTURE_TEST_START, name);
+
+    __test_quiet = true;
+    __bench_items_count = 0;
+
+    __test_call(name, fn); /* aquecimento */
+    __perf_reset();
+
+    for (int i = 0; i < __test_samples; i++)
+        samples[i] = __test_call(name, fn);
+
+    __test_quiet = false;
+    __test_function_timeout = 0;
+
+    memcpy(sorted, samples, sizeof(long long) * (size_t)__test_samples);
+    qsort(sorted, (size_t)__test_samples, sizeof(long long), __test_cmp_ll);
+
+    char median[32], min[32], max[32];
+    __test_format_ns(median, sizeof(median), (double)sorted[__test_samples / 2]);
+    __test_format_ns(min, sizeof(min), (double)sorted[0]);
+    __test_format_ns(max, sizeof(max), (double)sorted[__test_samples - 1]);
+
+    printf("   ⏱️  median %s  (min %s, max %s, %d samples)", median, min, max, __test_samples);
+
+    if (__bench_items_count > 0 && sorted[__test_samples / 2] > 0)
+        printf("  %.2f M items/s (%.1f ns/item)",
+               (double)__bench_items_count * 1e3 / (double)sorted[__test_samples / 2],
+               (double)sorted[__test_samples / 2] / (double)__bench_items_count);
+
+    printf("\n");
+
+    __test_record("bench", name, samples, __test_samples);
+    __perf_report(name);
+
+    __capture_event(__CAPTURE_TEST_END, name);
+}
+
+/* ===============================
+   Registro de testes (XTEST)
+   =============================== */
+
+/*
+ * XTEST(nome) define um teste sem depender da varredura do código
+ * fonte. Em ELF o descritor vai para a seção "xtest" e o linker gera
+ * __start_xtest/__stop_xtest; nos outros formatos um construtor
+ * registra o teste antes do main.
+ */
+
+typedef struct {
+    string name;
+    void (*fn)(void);
+    int timeout;
+} __test_entry;
+
+#if defined(__ELF__)
+
+extern const __test_entry __start_xtest[] __attribute__((weak));
+extern const __test_entry __stop_xtest[] __attribute__((weak));
+
+#define XTEST(name)                                                        \
+    static void name(void);                                                \
+    static const __test_entry __xtest_entry_##name                         \
+        __attribute__((used, section("xtest"), aligned(sizeof(void *)))) = \
+            {#name, name, 0};                                              \
+    static void name(void)
+
+#else
+
+#define __TEST_MAX_REGISTERED 1024
+
+static __test_entry __test_registry[__TEST_MAX_REGISTERED];
+static size_t __test_registry_count = 0;
+
+static void __test_register(string name, void (*fn)(void))
+{
+    if (__test_registry_count < __TEST_MAX_REGISTERED)
+        __test_registry[__test_registry_count++] = (__test_entry){name, fn, 0};
+}
+
+#define XTEST(name)                                                      \
+    static void name(void);                                              \
+    __attribute__((constructor)) static void __xtest_register_##name(void) \
+    {                                                                    \
+        __test_register(#name, name);                                    \
+    }                                                                    \
+    static void name(void)
+
+#endif
+
+/* glob com * e ?, usado por --filter */
+static bool __test_glob(string pattern, string text)
+{
+    if (*pattern == '\0')
+        return *text == '\0';
+
+    if (*pattern == '*')
+        return __test_glob(pattern + 1, text) || (*text && __test_glob(pattern, text + 1));
+
+    if (*text && (*pattern == '?' || *pattern == *text))
+        return __test_glob(pattern + 1, text + 1);
+
+    return false;
+}
+
+/* --filter aceita vários padrões separados por vírgula */
+static bool __test_matches(string filter, string name)
+{
+    if (!filter || !*filter)
+        return true;
+
+    char pattern[256];
+
+    while (*filter)
+    {
+        size_t len = strcspn(filter, ",");
+
+        if (len < sizeof(pattern))
+        {
+            memcpy(pattern, filter, len);
+            pattern[len] = '\0';
+
+            if (__test_glob(pattern, name))
+                return true;
+        }
+
+        filter += len;
+        if (*filter == ',')
+            filter++;
+    }
+
+    return false;
+}
+
+/* ===============================
+   Repetição (assertx --repeat)
+   =============================== */
+
+/* sem --seed, --shuffle ou --repeat fica a semente padrão do rand(), 1 */
+static unsigned long long __test_seed_value = 1;
+
+/* semente da execução atual; muda a cada repetição com --repeat */
+__TEST_API unsigned long long test_seed(void)
+{
+    return __test_seed_value;
+}
+
+static void __test_set_seed(unsigned long long seed)
+{
+    __test_seed_value = seed;
+    srand((unsigned)seed);
+}
+
+/* splitmix64 */
+static unsigned long long __test_next_random(unsigned long long *state)
+{
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static void __test_shuffle(size_t *order, size_t count, unsigned long long seed)
+{
+    unsigned long long state = seed;
+
+    for (size_t i = count; i > 1; i--)
+    {
+        size_t j = (size_t)(__test_next_random(&state) % i);
+        size_t swap = order[i - 1];
+
+        order[i - 1] = order[j];
+        order[j] = swap;
+    }
+}
+
+#ifndef _WIN32
+
+typedef struct {
+    int runs;
+    int passes;
+    int failed;
+    char failure[160];
+} __repeat_stat;
+
+typedef struct {
+    __repeat_stat *stats;
+    long long *durations;
+    int *current;
+    int *position;
+    int repeat;
+} __repeat_shared;
+
+static void __repeat_fail(__repeat_stat *stat, string reason)
+{
+    if (__test_atomic_add(&stat->failed, 1) == 0)
+        snprintf(stat->failure, sizeof(stat->failure), "%s", reason ? reason : "failed");
+}
+
+/* uma repetição a partir da posição start, num processo filho que nunca retorna */
+__attribute__((noreturn))
+static void __repeat_child(const __test_entry **selected, size_t count, __repeat_shared *shared,
+                           int iteration, size_t start, bool shuffle, unsigned long long seed)
+{
+    /* a saída dos filhos se misturaria; só o processo pai escreve */
+    int null_fd = open("/dev/null", O_WRONLY);
+
+    fflush(stdout);
+
+    if (null_fd >= 0)
+    {
+        dup2(null_fd, STDOUT_FILENO);
+        close(null_fd);
+    }
+
+    __capture = NULL;
+    __trace_path = NULL;
+    __test_results_path = NULL;
+    __test_resume_path = NULL;
+    __test_quiet = true;
+
+    __test_set_seed(seed + (unsigned long long)iteration);
+
+    size_t *order = malloc(sizeof(size_t) * count);
+
+    if (!order)
+        _exit(1);
+
+    for (size_t i = 0; i < count; i++)
+        order[i] = i;
+
+    if (shuffle)
+        __test_shuffle(order, count, __test_seed_value);
+
+    for (size_t k = start; k < count; k++)
+    {
+        size_t i = order[k];
+        __repeat_stat *stat = &shared->stats[i];
+        int failures = __test_failures;
+
+        __test_atomic_store(&shared->position[iteration], (int)k);
+        __test_atomic_store(&shared->current[iteration], (int)i);
+
+        __test_last_failure = NULL;
+        __test_function_timeout = selected[i]->timeout;
+
+        long long elapsed = __test_call(selected[i]->name, selected[i]->fn);
+
+        shared->durations[i * (size_t)shared->repeat + (size_t)iteration] = elapsed;
+
+        __test_atomic_add(&stat->runs, 1);
+
+        if (__test_failures == failures)
+            __test_atomic_add(&stat->passes, 1);
+        else
+            __repeat_fail(stat, __test_last_failure);
+
+        __test_atomic_store(&shared->current[iteration], -1);
+    }
+
+    _exit(0);
+}
+
+/*
+ * Roda a seleção inteira repeat vezes, cada repetição num filho, com
+ * até um filho por CPU ao mesmo tempo. Os resultados vão para memória
+ * compartilhada criada antes do fork, então um filho que cai ou
+ * estoura o tempo ainda deixa registrado em qual teste estava.
+ */
+static int __test_repeat(const __test_entry **selected, size_t count, int repeat,
+                         bool shuffle, unsigned long long seed)
+{
+    size_t stats_size = sizeof(__repeat_stat) * count;
+    size_t durations_size = sizeof(long long) * count * (size_t)repeat;
+    size_t size = stats_size + durations_size + 2 * sizeof(int) * (size_t)repeat;
+
+    char *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    if (map == MAP_FAILED)
+    {
+        printf("❌ --repeat could not map shared memory\n");
+        return 1;
+    }
+
+    __repeat_shared shared = {
+        (__repeat_stat *)map,
+        (long long *)(map + stats_size),
+        (int *)(map + stats_size + durations_size),
+        (int *)(map + stats_size + durations_size) + repeat,
+        repeat,
+    };
+
+    for (size_t i = 0; i < count * (size_t)repeat; i++)
+        shared.durations[i] = -1;
+
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    string reserved = getenv("ASSERTX_JOBS"); /* CPUs reservados por assertx --isolate */
+
+    if (reserved && atol(reserved) > 0 && atol(reserved) < jobs)
+        jobs = atol(reserved);
+    if (jobs < 1)
+        jobs = 1;
+    if (jobs > repeat)
+        jobs = repeat;
+
+    printf("🔁 Repeating %zu tests %d times (%ld in parallel, seed %llu%s)\n",
+           count, repeat, jobs, seed, shuffle ? ", shuffled" : "");
+    fflush(stdout);
+
+    pid_t *pids = calloc((size_t)repeat, sizeof(pid_t));
+
+    if (!pids)
+    {
+        printf("❌ --repeat could not allocate %d process slots\n", repeat);
+        munmap(map, size);
+        return 1;
+    }
+
+    int next = 0;
+    int running = 0;
+
+    while (next < repeat || running > 0)
+    {
+        while (next < repeat && running < jobs)
+        {
+            int iteration = next++;
+
+            shared.current[iteration] = -1;
+
+            pid_t pid = fork();
+
+            if (pid == 0)
+                __repeat_child(selected, count, &shared, iteration, 0, shuffle, seed);
+
+            if (pid < 0)
+            {
+                perror("fork");
+                next = repeat;
+                break;
+            }
+
+            pids[iteration] = pid;
+            running++;
+        }
+
+        if (running == 0)
+            break;
+
+        int status;
+        pid_t done = wait(&status);
+
+        if (done < 0)
+            break;
+
+        running--;
+
+        for (int iteration = 0; iteration < repeat; iteration++)
+        {
+            if (pids[iteration] != done)
+                continue;
+
+            int index = __test_atomic_load(&shared.current[iteration]);
+
+            /* o filho morreu no meio de um teste: conta como falha dele */
+            if (index >= 0)
+            {
+                char reason[64];
+
+                if (WIFSIGNALED(status))
+                    snprintf(reason, sizeof(reason), "crashed (signal %d)", WTERMSIG(status));
+                else if (WIFEXITED(status) && WEXITSTATUS(status) == 124)
+                    snprintf(reason, sizeof(reason), "timed out");
+                else
+                    snprintf(reason, sizeof(reason), "exited with %d", WEXITSTATUS(status));
+
+                /* outros filhos ainda podem estar somando no mesmo campo */
+                __test_atomic_add(&shared.stats[index].runs, 1);
+                __repeat_fail(&shared.stats[index], reason);
+
+                /* a repetição segue num filho novo, a partir do teste seguinte */
+                size_t resume = (size_t)__test_atomic_load(&shared.position[iteration]) + 1;
+
+                if (resume < count)
+                {
+                    shared.current[iteration] = -1;
+
+                    pid_t pid = fork();
+
+                    if (pid == 0)
+                        __repeat_child(selected, count, &shared, iteration, resume, shuffle, seed);
+
+                    if (pid > 0)
+                    {
+                        pids[iteration] = pid;
+                        running++;
+                    }
+                    else
+                        perror("fork");
+                }
+            }
+
+            break;
+        }
+    }
+
+    free(pids);
+
+    int flaky = 0;
+    int failing = 0;
+    long long samples[__TEST_MAX_SAMPLES];
+    long long *sorted = malloc(sizeof(long long) * (size_t)repeat);
+
+    if (!sorted)
+    {
+        printf("❌ --repeat could not allocate %d durations\n", repeat);
+        munmap(map, size);
+        return 1;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        __repeat_stat *stat = &shared.stats[i];
+        int measured = 0;
+
+        for (int r = 0; r < repeat; r++)
+        {
+            long long duration = shared.durations[i * (size_t)repeat + (size_t)r];
+
+            if (duration >= 0)
+                sorted[measured++] = duration;
+        }
+
+        string verdict = "✅";
+
+        if (stat->passes == 0)
+        {
+            verdict = "❌";
+            failing++;
+        }
+        else if (stat->passes < stat->runs)
+        {
+            verdict = "⚠️ flaky";
+            flaky++;
+        }
+
+        printf("   %s %s  %d/%d passed", verdict, selected[i]->name, stat->passes, stat->runs);
+
+        if (measured > 0)
+        {
+            char median[32], min[32], max[32];
+
+            qsort(sorted, (size_t)measured, sizeof(long long), __test_cmp_ll);
+
+            __test_format_ns(median, sizeof(median), (double)sorted[measured / 2]);
+            __test_format_ns(min, sizeof(min), (double)sorted[0]);
+            __test_format_ns(max, sizeof(max), (double)sorted[measured - 1]);
+
+            printf("  median %s (min %s, max %s)", median, min, max);
+
+            int kept = measured < __TEST_MAX_SAMPLES ? measured : __TEST_MAX_SAMPLES;
+
+            memcpy(samples, sorted, sizeof(long long) * (size_t)kept);
+            __test_record("test", selected[i]->name, samples, kept);
+        }
+
+        printf("\n");
+
+        if (stat->failed > 0)
+            printf("      first failure: %s\n", stat->failure);
+    }
+
+    free(sorted);
+    munmap(map, size);
+
+    printf("\n----------------------------------\n");
+    printf("Runs      : %d\n", repeat);
+    printf("Flaky     : %d\n", flaky);
+    printf("Failing   : %d\n", failing);
+    printf("----------------------------------\n");
+
+    return flaky + failing > 0;
+}
+
+#else
+
+static int __test_repeat(const __test_entry **selected, size_t count, int repeat,
+                         bool shuffle, unsigned long long seed)
+{
+    (void)selected;
+    (void)count;
+    (void)repeat;
+    (void)shuffle;
+    (void)seed;
+
+    printf("❌ --repeat needs fork(), which this platform does not have\n");
+    return 1;
+}
+
+#endif
+
+/*
+ * main genérico: junta a tabela gerada pelo runner com os testes
+ * registrados por XTEST e aceita em tempo de execução:
+ *   --list            lista os testes e sai
+ *   --filter=<glob>   roda só os testes cujo nome casa com o padrão
+ *   --shard=<i>/<n>   roda só a fatia i (base 0) de n
+ *   --repeat=<n>      roda tudo n vezes em paralelo e aponta testes instáveis
+ *   --shuffle         embaralha a ordem dos testes
+ *   --seed=<n>        semente base (test_seed() devolve a da execução)
+ */
+static int __test_run_all(int argc, char **argv, const __test_entry *table, size_t count,
+                          const __test_fixtures *fixtures)
+{
+    string filter = NULL;
+    bool list = false;
+    int shard_index = 0;
+    int shard_count = 1;
+    int repeat = 1;
+    size_t start = 0;
+    bool shuffle = false;
+    bool seeded = false;
+    unsigned long long seed = 0;
+
+    __test_configure();
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--list") == 0)
+            list = true;
+        else if (strncmp(argv[i], "--filter=", 9) == 0)
+            filter = argv[i] + 9;
+        else if (strncmp(argv[i], "--repeat=", 9) == 0)
+            repeat = atoi(argv[i] + 9);
+        else if (strncmp(argv[i], "--start=", 8) == 0) /* o runner recomeçando depois de um estouro */
+            start = (size_t)strtoull(argv[i] + 8, NULL, 10);
+        else if (strcmp(argv[i], "--shuffle") == 0)
+            shuffle = true;
+        else if (strncmp(argv[i], "--seed=", 7) == 0)
+        {
+            seed = strtoull(argv[i] + 7, NULL, 10);
+            seeded = true;
+        }
+        else if (strncmp(argv[i], "--shard=", 8) == 0)
+        {
+            if (sscanf(argv[i] + 8, "%d/%d", &shard_index, &shard_count) != 2 ||
+                shard_count < 1 || shard_index < 0 || shard_index >= shard_count)
+            {
+                printf("❌ Invalid shard: %s\n", argv[i] + 8);
+                return 2;
+            }
+        }
+    }
+
+    const __test_entry *registered = NULL;
+    size_t registered_count = 0;
+
+#if defined(__ELF__)
+    if (__start_xtest && __stop_xtest)
+    {
+        registered = __start_xtest;
+        registered_count = (size_t)(__stop_xtest - __start_xtest);
+    }
+#else
+    registered = __test_registry;
+    registered_count = __test_registry_count;
+#endif
+
+    size_t total = count + registered_count;
+    const __test_entry **selected = malloc(sizeof(*selected) * (total ? total : 1));
+    size_t selected_count = 0;
+
+    for (size_t i = 0; i < total; i++)
+    {
+        const __test_entry *entry = i < count ? &table[i] : &registered[i - count];
+
+        if ((int)(i % (size_t)shard_count) != shard_index)
+            continue;
+
+        if (__test_matches(filter, entry->name))
+            selected[selected_count++] = entry;
+    }
+
+    if (list)
+    {
+        for (size_t i = 0; i < selected_count; i++)
+            printf("%s\n", selected[i]->name);
+
+        free(selected);
+        return 0;
+    }
+
+    if (!seeded)
+        seed = (unsigned long long)__test_now_ns();
+
+    /* --filter ou --shard sem nenhum teste: não há para quem montar a suite */
+    if (selected_count == 0)
+    {
+        printf("Running 0 tests...\n");
+        free(selected);
+        return __test_report();
+    }
+
+    if (!__test_suite_begin(fixtures))
+    {
+        __test_suite_end();
+        free(selected);
+        return __test_report();
+    }
+
+    if (repeat > 1)
+    {
+        int failed = __test_repeat(selected, selected_count, repeat, shuffle, seed);
+
+        __test_suite_end();
+        free(selected);
+        return failed;
+    }
+
+    size_t *order = malloc(sizeof(size_t) * (selected_count ? selected_count : 1));
+
+    for (size_t i = 0; i < selected_count; i++)
+        order[i] = i;
+
+    /* rand() só é semeado quando pedido, para não mudar testes que dependem dele */
+    if (seeded || shuffle)
+        __test_set_seed(seed);
+
+    if (shuffle)
+    {
+        __test_shuffle(order, selected_count, seed);
+        printf("🔀 Shuffled with seed %llu\n", seed);
+    }
+
+    if (start > 0)
+        printf("Running %zu of %zu tests, from test %zu...\n",
+               start < selected_count ? selected_count - start : 0, selected_count, start + 1);
+    else
+        printf("Running %zu tests...\n", selected_count);
+
+    for (size_t i = start; i < selected_count; i++)
+    {
+        __test_set_resume(i + 1, shuffle, seed);
+        __test_function_timeout = selected[order[i]]->timeout;
+        __test_run(selected[order[i]]->name, selected[order[i]]->fn);
+    }
+
+#ifndef _WIN32
+    __test_resume_text[0] = '\0';
+#endif
+    __test_function_timeout = 0;
+    free(order);
+    free(selected);
+
+    __test_suite_end();
+
+    return __test_report();
+}
+
+/* main dos executáveis gerados pelo runner */
+int __test_main(int argc, char **argv, const __test_entry *table, size_t count,
+                const __test_fixtures *fixtures)
+{
+    return __test_run_all(argc, argv, table, count, fixtures);
+}
+
+/* main dos executáveis de benchmark (assertx --bench) */
+int __test_bench_main(int argc, char **argv, const __test_entry *table, size_t count,
+                      const __test_fixtures *fixtures)
+{
+    string filter = NULL;
+
+    __test_configure();
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--filter=", 9) == 0)
+            filter = argv[i] + 9;
+    }
+
+    size_t selected_count = 0;
+
+    for (size_t i = 0; i < count; i++)
+        selected_count += __test_matches(filter, table[i].name);
+
+    printf("Running %zu benchmarks...\n", selected_count);
+
+    if (selected_count == 0)
+        return __test_report();
+
+    if (!__test_suite_begin(fixtures))
+    {
+        __test_suite_end();
+        return __test_report();
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!__test_matches(filter, table[i].name))
+            continue;
+
+        __test_function_timeout = table[i].timeout;
+        __test_bench(table[i].name, table[i].fn);
+    }
+
+    __test_function_timeout = 0;
+    __test_suite_end();
+
+    return __test_report();
+}
+
+/* ponto de entrada para arquivos que só usam XTEST */
+int xtest_main(int argc, char **argv)
+{
+    return __test_main(argc, argv, NULL, 0, NULL);
+}
+
+/* ===============================
+   Fuzzing (assertx --fuzz)
+   =============================== */
+
+#ifndef _WIN32
+
+#if defined(__clang__)
+#define __fuzz_nocov __attribute__((no_sanitize("coverage")))
+#elif defined(__GNUC__) && __GNUC__ >= 12
+#define __fuzz_nocov __attribute__((no_sanitize_coverage))
+#else
+#define __fuzz_nocov
+#endif
+
+#define __FUZZ_MAP_SIZE 65536
+#define __FUZZ_MAX_LEN 4096
+#define __FUZZ_MAX_CORPUS 4096
+
+typedef void (*__fuzz_fn)(const uint8_t *data, size_t len);
+
+static uint8_t __fuzz_map[__FUZZ_MAP_SIZE];
+static uintptr_t __fuzz_prev_pc;
+static size_t __fuzz_edges;
+
+static uint8_t *__fuzz_corpus[__FUZZ_MAX_CORPUS];
+static size_t __fuzz_corpus_len[__FUZZ_MAX_CORPUS];
+static size_t __fuzz_corpus_count;
+
+static uint64_t __fuzz_rng = 0x9E3779B97F4A7C15ULL;
+
+static const uint8_t *__fuzz_input;
+static size_t __fuzz_input_len;
+static char __fuzz_crash_path[600];
+
+/* chamado pelo compilador em cada bloco com -fsanitize-coverage=trace-pc */
+__fuzz_nocov void __sanitizer_cov_trace_pc(void)
+{
+    uintptr_t pc = (uintptr_t)__builtin_return_address(0);
+    size_t edge = (size_t)((pc ^ __fuzz_prev_pc) & (__FUZZ_MAP_SIZE - 1));
+
+    __fuzz_prev_pc = pc >> 1;
+
+    if (!__fuzz_map[edge])
+    {
+        __fuzz_map[edge] = 1;
+        __fuzz_edges++;
+    }
+}
+
+__fuzz_nocov static inline uint64_t __fuzz_rand(void)
+{
+    __fuzz_rng ^= __fuzz_rng << 13;
+    __fuzz_rng ^= __fuzz_rng >> 7;
+    __fuzz_rng ^= __fuzz_rng << 17;
+    return __fuzz_rng;
+}
+
+__fuzz_nocov static uint64_t __fuzz_hash(const uint8_t *data, size_t len)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+
+    for (size_t i = 0; i < len; i++)
+        h = (h ^ data[i]) * 0x100000001b3ULL;
+
+    return h;
+}
+
+__fuzz_nocov static void __fuzz_write_file(string path, const uint8_t *data, size_t len)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+
+    if (fd < 0)
+        return;
+
+    while (len > 0)
+    {
+        ssize_t n = write(fd, data, len);
+        if (n <= 0)
+            break;
+        data += n;
+        len -= (size_t)n;
+    }
+
+    close(fd);
+}
+
+__fuzz_nocov static void __fuzz_corpus_add(const uint8_t *data, size_t len,
+                                          string dir, bool persist)
+{
+    if (__fuzz_corpus_count >= __FUZZ_MAX_CORPUS)
+        return;
+
+    uint8_t *copy = malloc(len ? len : 1);
+
+    if (!copy)
+        return;
+
+    memcpy(copy, data, len);
+
+    __fuzz_corpus[__fuzz_corpus_count] = copy;
+    __fuzz_corpus_len[__fuzz_corpus_count] = len;
+    __fuzz_corpus_count++;
+
+    if (persist)
+    {
+        char path[700];
+        snprintf(path, sizeof(path), "%s/corpus/%016llx", dir,
+                 (unsigned long long)__fuzz_hash(data, len));
+        __fuzz_write_file(path, data, len);
+    }
+}
+
+__fuzz_nocov static void __fuzz_corpus_load(string dir)
+{
+    char corpus_dir[600];
+    snprintf(corpus_dir, sizeof(corpus_dir), "%s/corpus", dir);
+
+    DIR *d = opendir(corpus_dir);
+
+    if (!d)
+        return;
+
+    struct dirent *entry;
+    uint8_t buffer[__FUZZ_MAX_LEN];
+
+    while ((entry = readdir(d)) != NULL)
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+
+        char path[900];
+        snprintf(path, sizeof(path), "%s/%s", corpus_dir, entry->d_name);
+
+        FILE *f = fopen(path, "rb");
+
+        if (!f)
+            continue;
+
+        size_t len = fread(buffer, 1, sizeof(buffer), f);
+        fclose(f);
+
+        __fuzz_corpus_add(buffer, len, dir, false);
+    }
+
+    closedir(d);
+}
+
+__fuzz_nocov static size_t __fuzz_mutate(uint8_t *data, size_t len)
+{
+    static const uint8_t interesting[] = {0x00, 0x01, 0x7f, 0x80, 0xff, '"', '\\', '{', '}', '[', ']', ','};
+
+    int rounds = 1 + (int)(__fuzz_rand() % 4);
+
+    for (int r = 0; r < rounds; r++)
+    {
+        size_t pos = len ? (size_t)(__fuzz_rand() % len) : 0;
+
+        switch (__fuzz_rand() % 6)
+        {
+        case 0: /* flip bit */
+            if (len)
+                data[pos] ^= (uint8_t)(1u << (__fuzz_rand() % 8));
+            break;
+
+        case 1: /* byte aleatório */
+            if (len)
+                data[pos] = (uint8_t)__fuzz_rand();
+            break;
+
+        case 2: /* valor interessante */
+            if (len)
+                data[pos] = interesting[__fuzz_rand() % sizeof(interesting)];
+            break;
+
+        case 3: /* inserir byte */
+            if (len < __FUZZ_MAX_LEN)
+            {
+                memmove(data + pos + 1, data + pos, len - pos);
+                data[pos] = (uint8_t)(' ' + __fuzz_rand() % 95);
+                len++;
+            }
+            break;
+
+        case 4: /* remover byte */
+            if (len)
+            {
+                memmove(data + pos, data + pos + 1, len - pos - 1);
+                len--;
+            }
+            break;
+
+        case 5: /* splice com outra entrada do corpus */
+        {
+            size_t other = (size_t)(__fuzz_rand() % __fuzz_corpus_count);
+            size_t other_len = __fuzz_corpus_len[other];
+
+            if (other_len == 0)
+                break;
+
+            size_t from = (size_t)(__fuzz_rand() % other_len);
+            size_t n = other_len - from;
+
+            if (pos + n > __FUZZ_MAX_LEN)
+                n = __FUZZ_MAX_LEN - pos;
+
+            memcpy(data + pos, __fuzz_corpus[other] + from, n);
+
+            if (pos + n > len)
+                len = pos + n;
+            break;
+        }
+        }
+    }
+
+    return len;
+}
+
+__fuzz_nocov static void __fuzz_on_signal(int sig)
+{
+    static const char msg[] = "   💥 crash while fuzzing, input saved\n";
+
+    int fd = open(__fuzz_crash_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+
+    if (fd >= 0)
+    {
+        ssize_t ignored = write(fd, __fuzz_input, __fuzz_input_len);
+        (void)ignored;
+        close(fd);
+    }
+
+    __test_emergency_print(msg);
+
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+__fuzz_nocov static void __fuzz_exec(__fuzz_fn fn, const uint8_t *data, size_t len)
+{
+    __fuzz_input = data;
+    __fuzz_input_len = len;
+    __fuzz_prev_pc = 0;
+
+    fn(data, len);
+}
+
+__fuzz_nocov static void __fuzz_report(long runs, long long start_ns)
+{
+    long long elapsed = __test_now_ns() - start_ns;
+    long long per_sec = elapsed > 0 ? (long long)runs * 1000000000LL / elapsed : 0;
+
+    printf("   #%ld\tcov: %zu\tcorp: %zu\texec/s: %lld\n",
+           runs, __fuzz_edges, __fuzz_corpus_count, per_sec);
+    fflush(stdout);
+}
+
+/*
+ * Loop persistente: o alvo roda no mesmo processo a cada entrada.
+ * Entradas que cobrem novas arestas vão para <dir>/corpus e uma
+ * falha de asserção ou sinal salva a entrada em <dir>/crash-<hash>.
+ */
+__fuzz_nocov int __test_fuzz(string name, __fuzz_fn fn, string dir,
+                             long max_runs, long max_seconds)
+{
+    __test_configure();
+
+    printf("→ %s\n", name);
+
+    __test_quiet = true;
+    __fuzz_rng ^= (uint64_t)__test_now_ns();
+
+    for (size_t i = 0; i < __fuzz_corpus_count; i++)
+        free(__fuzz_corpus[i]);
+    __fuzz_corpus_count = 0;
+
+    __fuzz_corpus_load(dir);
+
+    if (__fuzz_corpus_count == 0)
+        __fuzz_corpus_add((const uint8_t *)"", 0, dir, false);
+
+    snprintf(__fuzz_crash_path, sizeof(__fuzz_crash_path), "%s/crash-signal", dir);
+
+    signal(SIGSEGV, __fuzz_on_signal);
+    signal(SIGABRT, __fuzz_on_signal);
+    signal(SIGFPE, __fuzz_on_signal);
+    signal(SIGBUS, __fuzz_on_signal);
+    signal(SIGILL, __fuzz_on_signal);
+
+    static uint8_t input[__FUZZ_MAX_LEN];
+    int failures_before = __test_failures;
+    long long start = __test_now_ns();
+    long long deadline = start + (long long)max_seconds * 1000000000LL;
+    long runs = 0;
+    long next_report = 1 << 16;
+
+    /* executa o corpus inicial para registrar sua cobertura */
+    for (size_t i = 0; i < __fuzz_corpus_count; i++)
+    {
+        __fuzz_exec(fn, __fuzz_corpus[i], __fuzz_corpus_len[i]);
+        runs++;
+    }
+
+    while (__test_failures == failures_before)
+    {
+        if (max_runs > 0 && runs >= max_runs)
+            break;
+
+        if ((runs & 1023) == 0 && max_seconds > 0 && __test_now_ns() >= deadline)
+            break;
+
+        size_t seed = (size_t)(__fuzz_rand() % __fuzz_corpus_count);
+        size_t len = __fuzz_corpus_len[seed];
+
+        memcpy(input, __fuzz_corpus[seed], len);
+        len = __fuzz_mutate(input, len);
+
+        size_t edges_before = __fuzz_edges;
+
+        __fuzz_exec(fn, input, len);
+        runs++;
+
+        if (__fuzz_edges > edges_before)
+            __fuzz_corpus_add(input, len, dir, true);
+
+        if (runs >= next_report)
+        {
+            __fuzz_report(runs, start);
+            next_report *= 2;
+        }
+    }
+
+    __fuzz_report(runs, start);
+
+    signal(SIGSEGV, SIG_DFL);
+    signal(SIGABRT, SIG_DFL);
+    signal(SIGFPE, SIG_DFL);
+    signal(SIGBUS, SIG_DFL);
+    signal(SIGILL, SIG_DFL);
+
+    __test_quiet = false;
+
+    if (__test_failures != failures_before)
+    {
+        char path[700];
+        snprintf(path, sizeof(path), "%s/crash-%016llx", dir,
+                 (unsigned long long)__fuzz_hash(__fuzz_input, __fuzz_input_len));
+        __fuzz_write_file(path, __fuzz_input, __fuzz_input_len);
+
+        printf("   ❌ %s failed, input saved to %s\n", name, path);
+        return 1;
+    }
+
+    printf("   ✅ %s: %ld runs without failures\n", name, runs);
+    return 0;
+}
+
+#endif
+
 #endif
@@ -1,3 +1,4 @@
+#include <limits.h>
 #include <stdio.h>
 #include "../src/xmath.h"
 #include "xassert.h"
@@ -11,10 +12,172 @@ void test_sum()
 void test_div()
 {
     assert_equal(xdiv(10, 0), -1, "10/0 should be -1");
+    assert_equal(xdiv(INT_MIN, -1), INT_MIN, "INT_MIN/-1 should wrap to INT_MIN");
+    assert_equal(xdiv(INT_MAX, -1), -INT_MAX, "INT_MAX/-1 should be -INT_MAX");
 }
 
 void test_is_even()
 {
     assert_true(is_even(4), "4 is even");
     assert_false(is_even(5), "5 is odd");
-}
\ No newline at end of file
+}
+
+
+/* ===============================
+   BATCH
+   =============================== */
+
+#define BATCH_N 1003
+
+static int batch_a[BATCH_N];
+static int batch_b[BATCH_N];
+static int batch_out[BATCH_N];
+static uint8_t batch_mask[(BATCH_N + 7) / 8];
+
+static void fill_batch()
+{
+    for (int i = 0; i < BATCH_N; i++)
+    {
+        batch_a[i] = (i * 7919) % 20011 - 10005;
+        batch_b[i] = (i % 5 == 0) ? 0 : (i * 104729) % 97 - 48;
+    }
+}
+
+void test_xsum_array()
+{
+    fill_batch();
+
+    for (int level = XMATH_SCALAR; level <= XMATH_AVX2; level++)
+    {
+        xmath_set_level((XMathLevel)level);
+        xsum_array(batch_a, batch_b, batch_out, BATCH_N);
+
+        bool same = true;
+        for (int i = 0; i < BATCH_N; i++)
+            same = same && batch_out[i] == xsum(batch_a[i], batch_b[i]);
+
+        assert_true(same, "xsum_array should match xsum at every level");
+    }
+
+    xmath_set_level(XMATH_AVX2);
+}
+
+void test_xdiv_array()
+{
+    fill_batch();
+
+    /* edge operands inside the vector blocks and in the scalar tail (1000..1002) */
+    static const int edges[][2] = {
+        {INT_MIN, -1}, {INT_MAX, -1}, {INT_MIN, 1}, {INT_MIN, INT_MIN},
+        {INT_MAX, INT_MIN}, {INT_MIN, INT_MAX}, {INT_MIN, 0}, {-1, INT_MIN},
+    };
+    static const int at[] = {3, 9, 14, 20, 27, 600, 1000, 1002};
+
+    for (int e = 0; e < 8; e++)
+    {
+        batch_a[at[e]] = edges[e][0];
+        batch_b[at[e]] = edges[e][1];
+    }
+
+    for (int level = XMATH_SCALAR; level <= XMATH_AVX2; level++)
+    {
+        xmath_set_level((XMathLevel)level);
+        xdiv_array(batch_a, batch_b, batch_out, BATCH_N);
+
+        bool same = true;
+        for (int i = 0; i < BATCH_N; i++)
+            same = same && batch_out[i] == xdiv(batch_a[i], batch_b[i]);
+
+        assert_true(same, "xdiv_array should match xdiv (including /0 = -1) at every level");
+    }
+
+    xmath_set_level(XMATH_AVX2);
+}
+
+void test_is_even_mask()
+{
+    fill_batch();
+
+    for (int level = XMATH_SCALAR; level <= XMATH_AVX2; level++)
+    {
+        xmath_set_level((XMathLevel)level);
+        is_even_mask(batch_a, BATCH_N, batch_mask);
+
+        bool same = true;
+        for (int i = 0; i < BATCH_N; i++)
+            same = same && ((batch_mask[i / 8] >> (i % 8)) & 1) == is_even(batch_a[i]);
+
+        assert_true(same, "is_even_mask should match is_even at every level");
+    }
+
+    xmath_set_level(XMATH_AVX2);
+}
+
+
+/* ===============================
+   BENCHMARKS
+   =============================== */
+
+void bench_xsum()
+{
+    volatile int sink = 0;
+
+    for (int i = 0; i < 1000000; i++)
+        sink = xsum(sink, i);
+
+    bench_items(1000000);
+}
+
+/* 4K ints fit in L1, 256K in L2/L3 and 8M (32 MB per array) go to DRAM */
+static void bench_batch(int op, size_t n)
+{
+    static int *a, *b, *out;
+    static uint8_t *mask;
+    static size_t size;
+
+    if (size < n)
+    {
+        free(a);
+        free(b);
+        free(out);
+        free(mask);
+
+        a = malloc(n * sizeof(int));
+        b = malloc(n * sizeof(int));
+        out = malloc(n * sizeof(int));
+        mask = malloc((n + 7) / 8);
+        size = n;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            a[i] = (int)(i * 2654435761u);
+            b[i] = (int)(i % 251) - 125;
+        }
+    }
+
+    size_t rounds = n < 8000000 ? 8000000 / n : 1;
+
+    for (size_t r = 0; r < rounds; r++)
+    {
+        if (op == 0)
+            xsum_array(a, b, out, n);
+        else if (op == 1)
+            xdiv_array(a, b, out, n);
+        else
+            is_even_mask(a, n, mask);
+    }
+
+    bench_items((long long)(n * rounds));
+}
+
+void bench_xsum_array_4k() { bench_batch(0, 4096); }
+void bench_xsum_array_256k() { bench_batch(0, 262144); }
+void bench_xsum_array_8m() { bench_batch(0, 8388608); }
+
+void bench_xdiv_array_4k() { bench_batch(1, 4096); }
+void bench_xdiv_array_256k() { bench_batch(1, 262144); }
+void bench_xdiv_array_8m() { bench_batch(1, 8388608); }
+
+void bench_is_even_mask_4k() { bench_batch(2, 4096); }
+void bench_is_even_mask_256k() { bench_batch(2, 262144); }
+void bench_is_even_mask_8m() { bench_batch(2, 8388608); }
@@ -0,0 +1,27 @@
+#include <stdio.h>
+
+#include "xassert.h"
+#include "../src/xmath.h"
+
+/*
+ * Tests registered with XTEST() instead of the void test_ naming
+ * convention. The runner does not need to see them: __test_main()
+ * finds them in the xtest section at run time.
+ */
+
+XTEST(xsum_registered)
+{
+    assert_equal(xsum(2, 3), 5, "xsum should add registered operands");
+}
+
+XTEST(xdiv_registered)
+{
+    assert_equal(xdiv(9, 3), 3, "xdiv should divide registered operands");
+    assert_equal(xdiv(1, 0), -1, "xdiv by zero should return -1");
+}
+
+XTEST(is_even_registered)
+{
+    assert_true(is_even(4), "4 should be even");
+    assert_false(is_even(7), "7 should not be even");
+}